@@ -0,0 +1,297 @@
+#include "frame_parser.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int16_t toCenti(float c) {
+  float v = c * 100.0f;
+  if (v >= 32767.0f) return 32767;
+  if (v <= -32768.0f) return -32768;
+  if (v != v) return 0; // NaN
+  return (int16_t)lroundf(v);
+}
+
+void frameDecodeInfoReset(FrameDecodeInfo *info) {
+  memset(info, 0, sizeof(*info));
+  info->source = FRAME_SRC_NONE;
+  info->envTemp = NAN;
+  info->minC = NAN;
+  info->maxC = NAN;
+}
+
+// 协议像素解码 (16-bit 小端) 写入 out[]，offsetC 用于开氏度->摄氏度平移；
+// 范围在浮点域统计，避免 int16 饱和掩盖异常值
+static void decodeProtocolPixels(const uint8_t *px, float offsetC, int16_t *out, float &mn, float &mx) {
+  for (uint16_t i = 0; i < MLX_FRAME_PIXELS; ++i) {
+    uint16_t v = (uint16_t)px[i*2 + 1] << 8 | px[i*2];
+    float tempC = v / 100.0f; // 默认缩放
+    if (tempC < -60 || tempC > 400) tempC = v / 16.0f; // 异常值备用方案
+    tempC += offsetC;
+    out[i] = toCenti(tempC);
+    if (i == 0 || tempC < mn) mn = tempC;
+    if (i == 0 || tempC > mx) mx = tempC;
+  }
+}
+
+// 按照协议：帧长度1544字节：
+// [0]=0x5A [1]=0x5A [2]=lenLow [3]=lenHigh (期望 0x02 0x06 => 0x0602=1538? 或 0x0206=518?)
+// 接着 1536 字节像素数据 (每像素1字节? 文档里目标温度数据1低8位、高8位 -> 2字节/像素 => 1536/2=768 像素 OK)
+// 然后 2 字节模块自身温度 (低/高) + 2 字节校验
+// 实际示例：总字节 1544 = 2(头) +2(长度)+1536(像素数据)+2(模块温度)+2(校验) = 1544
+// 像素逻辑：每像素两个连续字节组成 16bit 原始值；需转换为摄氏温度（暂时 raw/100）
+bool parseProtocolFrame(const uint8_t *raw, size_t rawLen, int16_t *out, FrameDecodeInfo *info) {
+  // 新解析逻辑：声明长度字段(declaredLen) = 像素数据(2*768=1536) + 模块温度(2) = 1538
+  // 完整帧总长度 = 2(帧头) + 2(长度) + declaredLen(1538) + 2(校验) = 1544
+  // 支持的 declaredLen 备选：
+  // 1538 = 像素(1536) + 模块温度(2) 不含校验
+  // 1536 = 仅像素数据 (可能模块温度单独或缺失)
+  // 1540 = 像素(1536) + 模块温度(2) + 校验前2?（某些文档差异）
+  const uint16_t ALT_DECLARED[3] = {1538, 1536, 1540};
+  // 计算一个最小帧需求（使用最小的 declaredLen=1536 -> 总=2+2+1536+2=1542）
+  const size_t MIN_FRAME_TOTAL = MLX_PROTOCOL_MIN_FRAME;
+  if (rawLen < MIN_FRAME_TOTAL) return false;
+
+  // 扫描整个缓冲寻找可能的帧头
+  for (size_t start = 0; start + MIN_FRAME_TOTAL <= rawLen; ++start) {
+    if (raw[start] != 0x5A || raw[start+1] != 0x5A) continue;
+    uint16_t declaredLen = (uint16_t)raw[start+3] * 256 + raw[start+2]; // 低在前（协议特殊顺序）
+    bool lenSupported = false;
+    for (uint16_t v : ALT_DECLARED) { if (declaredLen == v) { lenSupported = true; break; } }
+    if (!lenSupported) continue; // 尝试下一处帧头
+    size_t pixelDataOffset = start + 4; // 像素数据开始
+    size_t pixelBytes = MLX_FRAME_PIXELS * 2; // 固定 1536
+    size_t moduleTempOffset = pixelDataOffset + pixelBytes; // 模块温度2字节位置
+    // 校验位置：若 declaredLen 包含模块温度，则校验在其后两个字节；若不包含模块温度则需要调整
+    size_t checksumOffset;
+    if (declaredLen == 1536) {
+      // 帧结构：2(头)+2(len)+1536(像素)+2(校验) 总 1542
+      checksumOffset = pixelDataOffset + pixelBytes; // 紧随像素
+    } else if (declaredLen == 1538) {
+      // 2+2+1536+2(模块温度)+2(校验)=1544
+      checksumOffset = moduleTempOffset + 2;
+    } else { // 1540 假设：像素1536 + 模块温度2 + 额外填充2? + 校验2 => 总 2+2+1540+2=1546
+      checksumOffset = pixelDataOffset + declaredLen; // declaredLen全部数据之后
+    }
+    // 以下所有读取（像素、模块温度、校验、累加和）均不超过 checksumOffset+2
+    if (checksumOffset + 2 > rawLen) {
+      // 缓冲不足，放弃本帧
+      continue;
+    }
+    info->candidates++;
+    info->start = start;
+    info->frameLen = checksumOffset + 2 - start;
+    info->declaredLen = declaredLen;
+    // 解析像素 (16-bit 小端)，同时统计范围
+    float mn = 0, mx = 0;
+    decodeProtocolPixels(raw + pixelDataOffset, 0.0f, out, mn, mx);
+    // 模块环境温度
+    float moduleTemp = NAN;
+    if (declaredLen != 1536) { // 有模块温度字段
+      uint16_t moduleRaw = (uint16_t)raw[moduleTempOffset+1] << 8 | raw[moduleTempOffset];
+      moduleTemp = moduleRaw / 100.0f;
+    }
+    // 校验
+    uint16_t chk = (uint16_t)raw[checksumOffset+1] << 8 | raw[checksumOffset];
+    uint32_t sum = 0;
+    size_t sumEnd = (declaredLen == 1536) ? (pixelDataOffset + pixelBytes) : (declaredLen == 1538 ? (moduleTempOffset + 2) : (pixelDataOffset + declaredLen));
+    for (size_t i = start; i < sumEnd; ++i) {
+      sum += raw[i];
+    }
+    uint16_t sum16 = (uint16_t)(sum & 0xFFFF);
+    info->checksum = chk;
+    info->sum16 = sum16;
+    info->checksumOK = (chk == sum16);
+    info->envTemp = moduleTemp;
+    info->kelvinAdjusted = false;
+    // 合理性判定
+    bool valueOK = (mn > -55 && mx < 360 && (mx - mn) > 0.5);
+    if (!valueOK) {
+      // 再尝试开氏度->摄氏度转换
+      decodeProtocolPixels(raw + pixelDataOffset, -273.15f, out, mn, mx);
+      valueOK = (mn > -55 && mx < 360 && (mx - mn) > 0.5);
+      info->kelvinAdjusted = valueOK;
+    }
+    info->minC = mn;
+    info->maxC = mx;
+    if (valueOK) {
+      if (USE_STRICT_PROTOCOL && !info->checksumOK) {
+        info->strictRejected = true; // 严格模式：校验失败拒绝帧
+        return false;
+      }
+      info->source = FRAME_SRC_PROTOCOL;
+      return true; // 成功解析
+    }
+    // 数值不合理，继续寻找下一帧
+  }
+  return false; // 未找到有效帧
+}
+
+bool decodeBinaryFrame(const uint8_t *raw, size_t rawLen, bool littleEndian, int16_t *out, FrameDecodeInfo *info) {
+  if (rawLen < (size_t)MLX_FRAME_PIXELS * 2) return false; // 假定全是像素，至少 768 像素
+  float mn = 0, mx = 0;
+  for (size_t i = 0; i < MLX_FRAME_PIXELS; i++) { // 只取前768像素
+    uint8_t b1 = raw[2*i];
+    uint8_t b2 = raw[2*i + 1];
+    uint16_t v = littleEndian ? (b2 << 8 | b1) : (b1 << 8 | b2);
+    // 粗略转换：许多红外阵列原始值可能对应开氏度*100 或摄氏度*100
+    float tempC = (float)v / 100.0f; // 初步假设
+    // 过滤异常值
+    if (tempC < -60 || tempC > 400) {
+      // 尝试另一种缩放：/16
+      tempC = (float)v / 16.0f;
+    }
+    out[i] = toCenti(tempC);
+    // 简单合理性检查：在转换前统计范围（避免 int16 饱和掩盖异常值）
+    if (i == 0 || tempC < mn) mn = tempC;
+    if (i == 0 || tempC > mx) mx = tempC;
+  }
+  info->minC = mn;
+  info->maxC = mx;
+  // 判定是否合理：范围在 -50..350 且差值 > 1
+  if (mn > -55 && mx < 360 && (mx - mn) > 1) {
+    info->source = littleEndian ? FRAME_SRC_BINARY_LE : FRAME_SRC_BINARY_BE;
+    return true;
+  }
+  return false;
+}
+
+// 把 token 开头 strtod 会解析的数字前缀改写成等值的短串 (尾数有效数字 + 指数)，供超过栈缓冲的 token 使用：
+// 去掉前导 0，小数点位置并入指数，十六进制浮点 (0x...p...) 同样处理；超过 NUMBER_MAX_DIGITS 的有效数字
+// 不影响转换到 float 后的结果，直接丢弃。token 首字符须为数字
+#define NUMBER_MAX_DIGITS 40
+static void compactNumber(const uint8_t *p, size_t n, char *outStr, size_t cap) {
+  size_t i = 0, o = 0;
+  bool hex = n >= 3 && p[0] == '0' && (p[1] | 0x20) == 'x' &&
+             (isxdigit(p[2]) || (p[2] == '.' && n >= 4 && isxdigit(p[3])));
+  if (hex) {
+    outStr[o++] = '0'; outStr[o++] = 'x';
+    i = 2;
+  }
+  const int digitExp = hex ? 4 : 1; // 每位尾数对应的指数单位 (十六进制按 2 的幂)
+  long exp = 0;
+  int digits = 0;
+  bool inFraction = false;
+  for (; i < n; i++) {
+    uint8_t c = p[i];
+    if (c == '.' && !inFraction) { inFraction = true; continue; }
+    if (!(hex ? isxdigit(c) : isdigit(c))) break;
+    if (digits == 0 && c == '0') { // 前导 0
+      if (inFraction) exp -= digitExp;
+      continue;
+    }
+    if (digits < NUMBER_MAX_DIGITS) {
+      outStr[o++] = (char)c;
+      digits++;
+      if (inFraction) exp -= digitExp;
+    } else if (!inFraction) {
+      exp += digitExp; // 丢弃的整数位
+    }
+  }
+  if (digits == 0) outStr[o++] = '0';
+  // 可选指数：字母后至少要有一位数字，否则 strtod 不消费它
+  if (i < n && ((p[i] | 0x20) == (hex ? 'p' : 'e'))) {
+    size_t j = i + 1;
+    bool neg = false;
+    if (j < n && (p[j] == '+' || p[j] == '-')) neg = (p[j++] == '-');
+    if (j < n && isdigit(p[j])) {
+      long e = 0;
+      for (; j < n && isdigit(p[j]); j++) {
+        if (e < 1000000) e = e * 10 + (p[j] - '0'); // 饱和：足以溢出 / 下溢
+      }
+      exp += neg ? -e : e;
+    }
+  }
+  snprintf(outStr + o, cap - o, "%c%ld", hex ? 'p' : 'e', exp);
+}
+
+bool parseGYMCUData(const uint8_t *data, size_t len, int16_t *out, FrameDecodeInfo *info) {
+  // GYMCU90640可能的数据格式:
+  // 1. 十六进制格式
+  // 2. 逗号分隔的十进制
+  // 3. 固定长度二进制数据
+  // 4. 带帧头的格式
+  // 直接在捕获缓冲上扫描，使用栈上小缓冲取子串，不产生堆分配
+
+  int validCount = 0;
+
+  // 尝试解析十六进制格式 (常见于GYMCU模块)
+  bool hasHexPrefix = false;
+  for (size_t i = 0; i + 1 < len; i++) {
+    if (data[i] == '0' && data[i+1] == 'x') { hasHexPrefix = true; break; }
+  }
+  if (hasHexPrefix || len > 1000) {
+    // 可能是十六进制数据
+    for (size_t i = 0; i + 3 < len && validCount < MLX_FRAME_PIXELS; i++) {
+      if (data[i] == '0' && data[i+1] == 'x' && i + 6 <= len) {
+        char hexStr[5]; // 读取4位十六进制
+        memcpy(hexStr, data + i + 2, 4);
+        hexStr[4] = '\0';
+        int hexVal = strtol(hexStr, NULL, 16);
+        out[validCount] = toCenti((float)hexVal / 100.0f - 273.15f); // 转换为摄氏度
+        validCount++;
+        i += 5; // 跳过已处理的字符
+      }
+    }
+  }
+
+  // 尝试解析逗号分隔格式
+  if (validCount < 100) {
+    validCount = 0;
+    size_t startPos = 0;
+
+    for (size_t i = 0; i < len && validCount < MLX_FRAME_PIXELS; i++) {
+      char c = (char)data[i];
+      if (c == ',' || c == ' ' || c == '\n' || i == len - 1) {
+        // 截取 [startPos, i) 并去掉首尾空白
+        size_t s0 = startPos, s1 = i;
+        while (s0 < s1 && isspace(data[s0])) s0++;
+        while (s1 > s0 && isspace(data[s1-1])) s1--;
+
+        // 短 token 直接复制到栈缓冲；超长 token 压缩成等值短串，不截断也不分配
+        char tempStr[64];
+        size_t n = s1 - s0;
+        if (n > 0 && isdigit(data[s0])) {
+          if (n < sizeof(tempStr)) {
+            memcpy(tempStr, data + s0, n);
+            tempStr[n] = '\0';
+          } else {
+            compactNumber(data + s0, n, tempStr, sizeof(tempStr));
+          }
+          float temp = (float)atof(tempStr);
+          if (temp > -50 && temp < 150) { // 合理的温度范围
+            out[validCount] = toCenti(temp);
+            validCount++;
+          }
+        }
+        startPos = i + 1;
+      }
+    }
+  }
+
+  info->validCount = validCount;
+  if (validCount >= 400) { // 至少要有一半的数据
+    info->source = FRAME_SRC_TEXT;
+    return true;
+  }
+  return false;
+}
+
+bool decodeCapture(const uint8_t *raw, size_t rawLen, const int16_t *prev, int16_t *out, FrameDecodeInfo *info) {
+  frameDecodeInfoReset(info);
+  // 二进制猜测：是否接近 768 * 2 = 1536 字节（每像素 16bit）或其倍数
+  if (rawLen >= (size_t)MLX_FRAME_PIXELS * 2 && rawLen % 256 == 0) {
+    // 尝试小端和大端两种方式
+    if (decodeBinaryFrame(raw, rawLen, true, out, info) ||
+        decodeBinaryFrame(raw, rawLen, false, out, info)) {
+      return true;
+    }
+  }
+  // 协议帧解析尝试（可能在较小缓冲中没有满帧）
+  if (parseProtocolFrame(raw, rawLen, out, info)) return true;
+  // 文本格式可能只覆盖部分像素，未覆盖部分沿用上一帧
+  memcpy(out, prev, MLX_FRAME_PIXELS * sizeof(int16_t));
+  return parseGYMCUData(raw, rawLen, out, info);
+}
@@ -0,0 +1,70 @@
+// GYMCU90640 原始捕获解码器
+// 不依赖 Arduino：只读输入缓冲、只写输出槽与诊断结构，不打印、不触碰全局状态，
+// 可在主机 (env:native / test/fuzz) 上编译做单元测试与模糊测试。
+
+#ifndef FRAME_PARSER_H
+#define FRAME_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 可选严格模式：校验失败则拒绝帧
+#ifndef USE_STRICT_PROTOCOL
+#define USE_STRICT_PROTOCOL 0
+#endif
+
+#define MLX_FRAME_PIXELS 768          // 32x24
+#define MLX_PROTOCOL_MIN_FRAME 1542   // 2(头)+2(长度)+1536(像素)+2(校验)
+#define MLX_PROTOCOL_MAX_FRAME 1546   // declaredLen=1540 时
+
+// 解码结果来源
+enum FrameSource : uint8_t {
+  FRAME_SRC_NONE = 0,
+  FRAME_SRC_PROTOCOL,   // 0x5A 0x5A 协议帧
+  FRAME_SRC_BINARY_LE,  // 二进制猜测，小端
+  FRAME_SRC_BINARY_BE,  // 二进制猜测，大端
+  FRAME_SRC_TEXT,       // 十六进制 / 逗号分隔文本
+};
+
+// 解码诊断：由解码器填写，日志由调用方负责
+// 协议帧字段描述最后一个被完整检查的候选帧（无论接受与否）
+struct FrameDecodeInfo {
+  FrameSource source;     // 接受的解码器，拒绝时为 FRAME_SRC_NONE
+  size_t start;           // 协议帧头偏移
+  size_t frameLen;        // 协议帧总长度 (含头与校验)
+  uint16_t declaredLen;   // 协议长度字段
+  uint16_t checksum;      // 帧内校验字段
+  uint16_t sum16;         // 计算得到的累加和
+  bool checksumOK;
+  bool kelvinAdjusted;    // 是否经过 K->C 平移才通过合理性判定
+  bool strictRejected;    // 严格模式因校验失败拒绝
+  uint16_t candidates;    // 完整检查过的协议候选帧数
+  float envTemp;          // 模块温度 (°C)，无该字段时为 NAN
+  float minC;             // 最后一次尝试的像素范围 (°C)
+  float maxC;
+  int validCount;         // 文本解析得到的有效值个数
+};
+
+// 摄氏度 -> 厘摄氏度（饱和到 int16 范围 ±327.67°C）
+int16_t toCenti(float c);
+static inline float centiToC(int16_t v) { return v / 100.0f; }
+
+void frameDecodeInfoReset(FrameDecodeInfo *info);
+
+// 以下解码器把像素 (厘摄氏度) 写入 out[MLX_FRAME_PIXELS]；
+// 返回 false 时 out[] 内容无意义，调用方不得发布
+
+// 协议帧：在 raw 中扫描 0x5A 0x5A 帧头，支持 declaredLen = 1536 / 1538 / 1540
+bool parseProtocolFrame(const uint8_t *raw, size_t rawLen, int16_t *out, FrameDecodeInfo *info);
+
+// 二进制猜测：前 768*2 字节按 16-bit 像素解析
+bool decodeBinaryFrame(const uint8_t *raw, size_t rawLen, bool littleEndian, int16_t *out, FrameDecodeInfo *info);
+
+// 文本格式：只覆盖解析到的像素，调用方应预先填好 out[]（有效值 >= 400 视为成功）
+bool parseGYMCUData(const uint8_t *data, size_t len, int16_t *out, FrameDecodeInfo *info);
+
+// 完整捕获解码流程：二进制猜测 (长度为 256 整数倍时) -> 协议帧 -> 文本
+// prev 为当前已发布帧（只读），文本格式未覆盖的像素沿用 prev
+bool decodeCapture(const uint8_t *raw, size_t rawLen, const int16_t *prev, int16_t *out, FrameDecodeInfo *info);
+
+#endif
@@ -0,0 +1,34 @@
+// JSON 输出节拍器：按计划时刻限速而不是比较上一次发送时间
+// 不依赖 Arduino，可在主机 (env:native) 上测试。
+//
+// 每发送一帧计划时刻前进一个间隔；帧在计划时刻之前 jitterMs 以内到达也允许发送，
+// 传感器时钟略快或 UART 批量读取让帧提前几毫秒到达时不会被整帧跳过。
+// 长期平均速率仍不超过 1000/intervalMs；落后超过一个间隔时重新同步，不补发积压。
+
+#ifndef JSON_PACER_H
+#define JSON_PACER_H
+
+#include <stdint.h>
+
+struct JsonPacer {
+  uint32_t intervalMs;
+  uint32_t jitterMs;
+  uint32_t nextMs;
+  bool started;
+
+  void reset() { started = false; nextMs = 0; }
+
+  // now 时刻到达的帧是否应发送
+  bool due(uint32_t now) const {
+    return !started || (int32_t)(nextMs - now) <= (int32_t)jitterMs;
+  }
+
+  // 帧已发送：推进计划时刻
+  void sent(uint32_t now) {
+    if (!started || (int32_t)(now - nextMs) > (int32_t)intervalMs) nextMs = now;
+    started = true;
+    nextMs += intervalMs;
+  }
+};
+
+#endif
@@ -1,13 +1,35 @@
 #include <M5CoreS3.h>
 #include <HardwareSerial.h>
-// 可选严格模式：校验失败则拒绝帧
-#ifndef USE_STRICT_PROTOCOL
-#define USE_STRICT_PROTOCOL 0
-#endif
+#include <esp_heap_caps.h>
+#include <ArduinoJson.h>
+#include "frame_parser.h"
+#include "json_pacer.h"
 
 // 当前帧环境温度
 static float g_envTemp = NAN;
 
+// 格式化输出到固定静态缓冲再 Serial.write：Arduino Print::printf 的栈缓冲只有 64 字节，
+// 更长的行（中文日志 UTF-8 很容易超过）会临时 malloc。只在 loop 任务中调用；超长行截断
+#ifndef MLX_LOG_LINE_SIZE
+#define MLX_LOG_LINE_SIZE 256
+#endif
+static char g_logLine[MLX_LOG_LINE_SIZE];
+static void serialPrintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+static void serialPrintf(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(g_logLine, sizeof(g_logLine), fmt, ap);
+  va_end(ap);
+  if (n <= 0) return;
+  if ((size_t)n >= sizeof(g_logLine)) n = sizeof(g_logLine) - 1;
+  Serial.write((const uint8_t *)g_logLine, n);
+}
+
+// 调试日志开关：JSON 模式下关闭，保证 USB 串口只输出 NDJSON 行
+static bool g_verbose = true;
+#define MLX_LOG(...) do { if (g_verbose) serialPrintf(__VA_ARGS__); } while (0)
+#define MLX_LOGLN(s) do { if (g_verbose) Serial.println(s); } while (0)
+
 // 简单命令发送（根据说明书）
 // 波特率设置: 0xA5 0x05 0x15 0x01 0xBB (9600)
 // 查询自动输出: 0xA5 0x05 0x35 0x00 0xDB
@@ -18,9 +40,9 @@ HardwareSerial mlxSerial(2); // 使用Serial2
 void sendRawCommand(const uint8_t *data, size_t len) {
   mlxSerial.write(data, len);
   mlxSerial.flush();
-  Serial.print("发送命令: ");
-  for (size_t i=0;i<len;i++){ Serial.printf("%02X ", data[i]); }
-  Serial.println();
+  MLX_LOG("发送命令: ");
+  for (size_t i=0;i<len;i++){ MLX_LOG("%02X ", data[i]); }
+  MLX_LOGLN("");
 }
 
 void commandSetFrameRate(uint8_t rateCode) {
@@ -39,9 +61,6 @@ void commandQueryAutoOutput() {
 
 // (已上移) MLX90640 UART模式通信对象已在顶部定义
 
-// 温度数据数组 (32x24 = 768 像素)
-float frame[32*24];
-
 // UART引脚定义 (M5Stack Core S3)
 #define MLX_RX_PIN 44   // MLX90640的TX连接到S3的G44 (作为RX接收)
 #define MLX_TX_PIN 43   // MLX90640的RX连接到S3的G43 (作为TX发送)
@@ -50,21 +69,253 @@ float frame[32*24];
 #define MLX_BAUDRATE_DEFAULT 9600      // 默认波特率
 #define MLX_BAUDRATE_HIGH 115200       // 高速波特率
 #define MLX_BAUDRATE_ULTRA 460800      // 超高速波特率
-#define FRAME_SIZE 768
+#define FRAME_SIZE MLX_FRAME_PIXELS
+
+// ---- 静态内存预算 ----
+// 所有流水线缓冲在启动时一次性确定，不随运行动态增长：
+//   热缓冲（原始捕获、当前帧、解码槽、JSON 区）为零初始化全局数组，位于内部 SRAM 的 .bss
+//   （不加 DRAM_ATTR，否则会被放进 .data 随固件镜像占用 flash 并在启动时拷贝）；
+//   历史帧环启动时从 PSRAM 堆分配
+#ifndef MLX_RAW_BUF_SIZE
+#define MLX_RAW_BUF_SIZE 8192   // 原始串口捕获缓冲上限（字节）
+#endif
+#ifndef MLX_HISTORY_FRAMES
+#define MLX_HISTORY_FRAMES 16   // 历史帧数（每帧 768*2 = 1536 字节）
+#endif
+
+// 温度数据数组 (32x24 = 768 像素)，单位: 0.01°C (厘摄氏度)，比 float 省一半
+int16_t frame[FRAME_SIZE];
+
+// 解码工作槽：所有解析器只写这里，帧被接受后才由 publishFrame() 发布到 frame[]，
+// 被拒绝的帧不会改动已发布的 frame[] / g_envTemp
+static int16_t g_frameScratch[FRAME_SIZE];
+
+// 原始串口捕获缓冲（替代原先的 String + std::vector 双份缓存）
+static uint8_t g_rawBuf[MLX_RAW_BUF_SIZE];
+static size_t g_rawLen = 0;        // 最近一次捕获的字节数
+static size_t g_rawHighWater = 0;  // 捕获字节数高水位
+
+// 历史帧环：启动时从 PSRAM 一次性分配（无 PSRAM 时退回内部 SRAM）
+static int16_t *g_history = nullptr;
+static bool g_historyInPsram = false;
+static uint16_t g_historyHead = 0;
+static uint16_t g_historyCount = 0;
+
+// setup() 结束时的堆快照：内存报告据此给出运行期的净常驻分配增量
+static multi_heap_info_t g_bootHeap;
+
+// setup() 之后的分配计数：platformio.ini 用 -Wl,--wrap 把 malloc/calloc/realloc、
+// newlib 内部使用的 _malloc_r/_calloc_r/_realloc_r（stdio、浮点格式化）与
+// heap_caps_malloc/calloc/realloc 的调用都链接到下面的 __wrap_*，预编译库（Arduino 核心、
+// IDF、libstdc++ 的 operator new）里的调用同样经过这里；计数只在 setup() 结束后开启。
+// 缺少链接参数时 __real_* 无定义，链接直接失败，计数不会静默为 0
+static volatile bool g_allocCounting = false;
+static volatile uint32_t g_allocCount = 0;
+static volatile uint32_t g_allocBytes = 0;
+static volatile uintptr_t g_allocFirstCaller = 0; // 启动后第一次分配的返回地址，可用 addr2line 定位
+
+static inline void IRAM_ATTR countAlloc(size_t size, void *caller) {
+  if (!g_allocCounting) return;
+  if (__atomic_fetch_add(&g_allocCount, 1, __ATOMIC_RELAXED) == 0) g_allocFirstCaller = (uintptr_t)caller;
+  __atomic_fetch_add(&g_allocBytes, (uint32_t)size, __ATOMIC_RELAXED);
+}
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real__malloc_r(struct _reent *r, size_t size);
+void *__real__calloc_r(struct _reent *r, size_t n, size_t size);
+void *__real__realloc_r(struct _reent *r, void *ptr, size_t size);
+void *__real_heap_caps_malloc(size_t size, uint32_t caps);
+void *__real_heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void *__real_heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+
+void *IRAM_ATTR __wrap_malloc(size_t size) {
+  countAlloc(size, __builtin_return_address(0));
+  return __real_malloc(size);
+}
+void *IRAM_ATTR __wrap_calloc(size_t n, size_t size) {
+  countAlloc(n * size, __builtin_return_address(0));
+  return __real_calloc(n, size);
+}
+void *IRAM_ATTR __wrap_realloc(void *ptr, size_t size) {
+  if (size) countAlloc(size, __builtin_return_address(0)); // realloc(p, 0) 等同 free
+  return __real_realloc(ptr, size);
+}
+void *IRAM_ATTR __wrap__malloc_r(struct _reent *r, size_t size) {
+  countAlloc(size, __builtin_return_address(0));
+  return __real__malloc_r(r, size);
+}
+void *IRAM_ATTR __wrap__calloc_r(struct _reent *r, size_t n, size_t size) {
+  countAlloc(n * size, __builtin_return_address(0));
+  return __real__calloc_r(r, n, size);
+}
+void *IRAM_ATTR __wrap__realloc_r(struct _reent *r, void *ptr, size_t size) {
+  if (size) countAlloc(size, __builtin_return_address(0));
+  return __real__realloc_r(r, ptr, size);
+}
+void *IRAM_ATTR __wrap_heap_caps_malloc(size_t size, uint32_t caps) {
+  countAlloc(size, __builtin_return_address(0));
+  return __real_heap_caps_malloc(size, caps);
+}
+void *IRAM_ATTR __wrap_heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  countAlloc(n * size, __builtin_return_address(0));
+  return __real_heap_caps_calloc(n, size, caps);
+}
+void *IRAM_ATTR __wrap_heap_caps_realloc(void *ptr, size_t size, uint32_t caps) {
+  if (size) countAlloc(size, __builtin_return_address(0));
+  return __real_heap_caps_realloc(ptr, size, caps);
+}
+}
+
+// 当前帧是否为解析失败后的模拟数据
+static bool g_frameSimulated = false;
+
+// ---- JSON 输出模式 ----
+// 每帧一行 JSON (NDJSON) 写入 USB Serial，温度均为厘摄氏度整数 (scale=100)
+#ifndef MLX_JSON_ARENA_SIZE
+#define MLX_JSON_ARENA_SIZE 24576      // JsonDocument 固定内存区（含 768 像素数组）
+#endif
+#ifndef MLX_JSON_MIN_INTERVAL_MS
+#define MLX_JSON_MIN_INTERVAL_MS 125   // 输出间隔 (125ms = 8Hz)
+#endif
+#ifndef MLX_JSON_JITTER_MS
+#define MLX_JSON_JITTER_MS 30          // 帧比计划时刻提前不超过此值仍发送
+#endif
+#ifndef MLX_JSON_TX_BUF_SIZE
+#define MLX_JSON_TX_BUF_SIZE 8192      // USB CDC 发送缓冲，需能容纳一整帧含像素的 JSON
+#endif
+#ifndef MLX_UART_RX_BUF_SIZE
+#define MLX_UART_RX_BUF_SIZE 4096      // 传感器 UART 驱动接收缓冲，容纳两次轮询之间到达的数据
+#endif
+#ifndef MLX_JSON_RATE_WINDOW_MS
+#define MLX_JSON_RATE_WINDOW_MS 1000   // 速率统计行输出周期
+#endif
+
+// 字段选择位
+#define JSON_F_STATS  0x01   // min/max/avg/center
+#define JSON_F_ENV    0x02   // 模块环境温度
+#define JSON_F_PIXELS 0x04   // 完整 768 像素数组
+
+// ArduinoJson 固定区分配器：从静态内存区线性分配，deallocate 为空操作，
+// 每帧 reset() 整体回收，保证输出路径不触碰堆
+class JsonArenaAllocator : public ArduinoJson::Allocator {
+ public:
+  void *allocate(size_t size) override {
+    size = align(size);
+    if (used_ + size > sizeof(buf_)) { failures_++; return nullptr; }
+    uint8_t *p = buf_ + used_;
+    used_ += size;
+    last_ = p;
+    if (used_ > highWater_) highWater_ = used_;
+    return p;
+  }
+  void deallocate(void *) override {}
+  void *reallocate(void *ptr, size_t newSize) override {
+    if (!ptr) return allocate(newSize);
+    uint8_t *p = (uint8_t *)ptr;
+    if (p == last_) { // 末块原地伸缩
+      size_t end = (size_t)(p - buf_) + align(newSize);
+      if (end > sizeof(buf_)) { failures_++; return nullptr; }
+      used_ = end;
+      if (used_ > highWater_) highWater_ = used_;
+      return p;
+    }
+    // 非末块：另开新块并复制（旧大小未知，按新大小截到区尾）
+    uint8_t *q = (uint8_t *)allocate(newSize);
+    if (q) memmove(q, p, min<size_t>(newSize, (size_t)(buf_ + sizeof(buf_) - p)));
+    return q;
+  }
+  void reset() { used_ = 0; last_ = nullptr; }
+  size_t capacity() const { return sizeof(buf_); }
+  size_t highWater() const { return highWater_; }
+  uint32_t failures() const { return failures_; }
+
+ private:
+  static size_t align(size_t n) { return (n + 7) & ~(size_t)7; }
+  alignas(8) uint8_t buf_[MLX_JSON_ARENA_SIZE];
+  size_t used_ = 0;
+  size_t highWater_ = 0;
+  uint8_t *last_ = nullptr;
+  uint32_t failures_ = 0;
+};
+
+// 分块写入 USB Serial：ArduinoJson 逐字节输出，聚合后批量 write
+class SerialChunkWriter {
+ public:
+  size_t write(uint8_t c) {
+    buf_[len_++] = c;
+    if (len_ == sizeof(buf_)) flush();
+    return 1;
+  }
+  size_t write(const uint8_t *s, size_t n) {
+    for (size_t i = 0; i < n; ++i) write(s[i]);
+    return n;
+  }
+  void flush() {
+    if (len_) { Serial.write(buf_, len_); len_ = 0; }
+  }
+
+ private:
+  uint8_t buf_[256];
+  size_t len_ = 0;
+};
+
+// 仅计数的写入器（基准测试用）
+struct NullJsonWriter {
+  size_t write(uint8_t) { return 1; }
+  size_t write(const uint8_t *, size_t n) { return n; }
+};
+
+static JsonArenaAllocator g_jsonArena; // 内部 SRAM .bss
+static JsonDocument g_jsonDoc(&g_jsonArena);
+static bool g_jsonMode = false;
+static uint8_t g_jsonFields = JSON_F_STATS | JSON_F_ENV;
+static uint32_t g_jsonSeq = 0;
+static JsonPacer g_jsonPacer = {MLX_JSON_MIN_INTERVAL_MS, MLX_JSON_JITTER_MS, 0, false};
+static uint32_t g_jsonSent = 0;
+static uint32_t g_jsonDropped = 0;   // 发送缓冲不足而丢弃
+static uint32_t g_jsonSkipped = 0;   // 速率限制跳过
+static uint32_t g_streamFramesIn = 0; // 滚动采集发布的帧数
+static uint32_t g_streamStrictRejected = 0; // 严格模式下因校验失败丢弃的帧
+static bool g_streamDirty = false;    // 捕获缓冲有新数据 / 刚消费一帧，需要重新解析
+
+// 速率统计窗口：记录窗口起点的计数，每 MLX_JSON_RATE_WINDOW_MS 输出一行差值
+struct JsonRateWindow {
+  uint32_t startMs;
+  uint32_t in, sent, skipped, dropped, overflow;
+};
+static JsonRateWindow g_rateWin = {};
+static JsonRateWindow g_rateLast = {}; // 最近一个完整窗口的差值 (startMs 字段存窗口时长)
+static uint32_t g_jsonOverflow = 0;  // 固定区不足而丢弃
 
 // 函数声明
 bool testMLXConnection();
 bool readMLXFrame();
-bool parseGYMCUData(String data);
-bool parseProtocolFrame(const String &raw); // 协议帧解析前置声明
+void logDecodeInfo(const FrameDecodeInfo &info);
 void analyzeRawForPattern();                // 原始数据模式分析前置声明
-void generateTestData();
+void generateTestData(int16_t *out);
 void displaySimpleHeatmap();
 uint32_t scanBaud();
 void dumpRaw(uint16_t n);
+bool poolInit();
+void publishFrame(const int16_t *src, float envTemp);
+void pushHistory();
+void printHistory();
+void dumpCapture();
+void printMemReport();
+void handleSerialCommand();
+void buildJsonFrame(uint8_t fields);
+void emitJsonFrame();
+bool emitJsonLine();
+void emitJsonRate();
+void startJsonStream();
+bool pollStreamFrame();
+void mlxBegin(uint32_t baud);
+void printJsonConfig();
+void benchJson();
 
-// 原始数据缓冲（仅调试用，避免无限增长）
-static String g_rawData; // 存最新一次读取的原始串口块
 static uint32_t g_currentBaud = MLX_BAUDRATE_DEFAULT;
 
 void setup() {
@@ -72,15 +323,23 @@ void setup() {
   M5.begin();
   
   // 初始化串口
+#if ARDUINO_USB_CDC_ON_BOOT && ARDUINO_USB_MODE
+  Serial.setTxBufferSize(MLX_JSON_TX_BUF_SIZE); // 须在 begin 之前设置
+#endif
   Serial.begin(115200);
   while(!Serial) delay(10);
   
   Serial.println("GYMCU90640 UART模式红外摄像头测试");
+
+  // 一次性分配内存池
+  if (!poolInit()) {
+    Serial.println("内存池分配失败，历史帧功能停用");
+  }
   
   // 自动扫描可用波特率
   g_currentBaud = scanBaud();
-  mlxSerial.begin(g_currentBaud, SERIAL_8N1, MLX_RX_PIN, MLX_TX_PIN);
-  Serial.printf("选择波特率: %lu bps (RX=%d TX=%d)\n", (unsigned long)g_currentBaud, MLX_RX_PIN, MLX_TX_PIN);
+  mlxBegin(g_currentBaud);
+  serialPrintf("选择波特率: %lu bps (RX=%d TX=%d)\n", (unsigned long)g_currentBaud, MLX_RX_PIN, MLX_TX_PIN);
   
   // 等待传感器稳定
   delay(2000);
@@ -92,7 +351,7 @@ void setup() {
     Serial.println("尝试其他波特率...");
     // 尝试115200波特率
     mlxSerial.end();
-    mlxSerial.begin(MLX_BAUDRATE_HIGH, SERIAL_8N1, MLX_RX_PIN, MLX_TX_PIN);
+    mlxBegin(MLX_BAUDRATE_HIGH);
     delay(1000);
     
     if (testMLXConnection()) {
@@ -122,41 +381,56 @@ void setup() {
   M5.Lcd.println("BtnA=Capture BtnB=Heatmap BtnC=ToggleAuto");
   
   Serial.println("初始化完成！");
+  // 启动阶段结束：记录堆快照，此后的分配计入内存报告
+  // 预热 newlib 浮点格式化：dtoa 的 Bigint 首次使用时按任务分配并缓存到空闲链表，之后复用
+  for (float v = -60.0f; v < 400.0f; v += 37.37f) snprintf(g_logLine, sizeof(g_logLine), "%.2f %.1f", v, v / 3);
+  heap_caps_get_info(&g_bootHeap, MALLOC_CAP_8BIT);
+  g_allocCounting = true;
 }
 
 void loop() {
   M5.update();
+  handleSerialCommand();
+
+  // JSON 输出模式：滚动采集（不重开捕获窗口），按速率限制输出并定期报告实际帧率
+  if (g_jsonMode) {
+    if (pollStreamFrame()) emitJsonFrame();
+    emitJsonRate();
+  }
   
   // 按下按钮A读取温度数据
-  // 长按A键 (>1.5s)输出原始数据调试
-  if (M5.BtnA.pressedFor(1500)) {
+  // 长按A键 (>1.5s)输出原始数据调试；JSON 模式下停用，原始十六进制会破坏 NDJSON 流
+  if (!g_jsonMode && M5.BtnA.pressedFor(1500)) {
     dumpRaw(512); // 输出前512字节
   }
 
   if (M5.BtnC.wasPressed()) {
     static bool autoOn=false; autoOn=!autoOn; commandSetAutoOutput(autoOn);
-    Serial.printf("切换自动输出: %s\n", autoOn?"ON":"OFF");
+    MLX_LOG("切换自动输出: %s\n", autoOn?"ON":"OFF");
   }
 
   if (M5.BtnB.pressedFor(1500)) {
     static uint8_t rate=0; // 0..4
     rate = (rate+1)%5; commandSetFrameRate(rate);
-    Serial.printf("切换帧率代码=%u\n", rate);
+    MLX_LOG("切换帧率代码=%u\n", rate);
   }
 
-  if (M5.BtnA.wasPressed()) {
+  // JSON 模式由串口流持续采集，按键手动采集停用（避免插入调试文本、打断流）
+  if (!g_jsonMode && M5.BtnA.wasPressed()) {
     Serial.println("读取MLX90640数据...");
     
     // 获取温度帧数据
     if (readMLXFrame()) {
       // 计算最大最小温度
-      float minTemp = frame[0];
-      float maxTemp = frame[0];
+      int16_t minC = frame[0];
+      int16_t maxC = frame[0];
       
       for (int i = 1; i < 768; i++) {
-        if (frame[i] < minTemp) minTemp = frame[i];
-        if (frame[i] > maxTemp) maxTemp = frame[i];
+        if (frame[i] < minC) minC = frame[i];
+        if (frame[i] > maxC) maxC = frame[i];
       }
+      float minTemp = centiToC(minC);
+      float maxTemp = centiToC(maxC);
       
       // 在屏幕上显示温度信息
       M5.Lcd.fillRect(0, 80, 320, 160, BLACK);
@@ -170,11 +444,11 @@ void loop() {
       // 显示中心点温度
       int centerIndex = 16 * 24 + 12; // 中心像素 (16, 12)
   M5.Lcd.setCursor(10, 150);
-  M5.Lcd.printf("Center: %.1f C Env:%.1f C", frame[centerIndex], isnan(g_envTemp)?-1:g_envTemp);
+  M5.Lcd.printf("Center: %.1f C Env:%.1f C", centiToC(frame[centerIndex]), isnan(g_envTemp)?-1:g_envTemp);
       
       // 串口输出详细信息
-      Serial.printf("温度范围: %.2f - %.2f 摄氏度\n", minTemp, maxTemp);
-      Serial.printf("中心温度: %.2f 摄氏度\n", frame[centerIndex]);
+      serialPrintf("温度范围: %.2f - %.2f 摄氏度\n", minTemp, maxTemp);
+      serialPrintf("中心温度: %.2f 摄氏度\n", centiToC(frame[centerIndex]));
     } else {
       Serial.println("读取失败！");
       M5.Lcd.fillRect(0, 80, 320, 40, BLACK);
@@ -186,11 +460,17 @@ void loop() {
   }
   
   // 按下按钮B显示简单的热力图
-  if (M5.BtnB.wasPressed()) {
+  if (!g_jsonMode && M5.BtnB.wasPressed()) {
     displaySimpleHeatmap();
   }
   
-  delay(50);
+  delay(g_jsonMode ? 1 : 50); // JSON 模式只让出 CPU，避免拖慢采集
+}
+
+// 打开传感器 UART；接收缓冲须在 begin 之前设置，end() 之后每次重新设置
+void mlxBegin(uint32_t baud) {
+  mlxSerial.setRxBufferSize(MLX_UART_RX_BUF_SIZE);
+  mlxSerial.begin(baud, SERIAL_8N1, MLX_RX_PIN, MLX_TX_PIN);
 }
 
 // 测试GYMCU90640连接
@@ -237,161 +517,110 @@ bool testMLXConnection() {
 #ifndef MLX_EARLY_STOP_ENABLED
 #define MLX_EARLY_STOP_ENABLED 1   // 检测到完整帧提前结束
 #endif
+#ifndef MLX_SIMULATE_ON_FAIL
+#define MLX_SIMULATE_ON_FAIL 0     // 1=全部解析失败时发布模拟帧（界面调试用，标记 sim、环境温度置 NAN）
+#endif
 
 bool readMLXFrame() {
-  Serial.printf("等待GYMCU90640数据窗口 %u ms...\n", MLX_CAPTURE_WINDOW_MS);
+  MLX_LOG("等待GYMCU90640数据窗口 %u ms...\n", MLX_CAPTURE_WINDOW_MS);
   uint32_t start = millis();
-  g_rawData = ""; // 重置文本缓冲
-  // 二进制缓冲
-  static std::vector<uint8_t> binBuf; binBuf.clear(); binBuf.reserve(4096);
+  g_rawLen = 0; // 重置捕获缓冲（固定容量，不再动态增长）
+  g_frameSimulated = false;
   const size_t EARLY_FRAME_TOTAL = 1544; // 预期完整帧总字节
-  bool frameFound = false;
   int frameParseSuccess = 0;
   while (millis() - start < MLX_CAPTURE_WINDOW_MS) {
-    while (mlxSerial.available()) {
-      int b = mlxSerial.read();
-      if (b < 0) break;
-      uint8_t ub = (uint8_t)b;
-      binBuf.push_back(ub);
-      g_rawData += (char)ub; // 保持原有接口兼容
-      // 早期检测：长度达到最小帧，尝试协议解析
-      if (MLX_EARLY_STOP_ENABLED && binBuf.size() >= EARLY_FRAME_TOTAL && !frameFound) {
+    int avail = mlxSerial.available();
+    if (avail > 0) {
+      g_rawLen += mlxSerial.read(g_rawBuf + g_rawLen, min<size_t>(avail, MLX_RAW_BUF_SIZE - g_rawLen));
+      // 早期检测：每批数据到达后尝试一次协议解析（不再逐字节重扫整个缓冲）
+      if (MLX_EARLY_STOP_ENABLED && g_rawLen >= EARLY_FRAME_TOTAL) {
         // 尝试在现有数据里解析帧
-        if (parseProtocolFrame(g_rawData)) {
-          frameFound = true; frameParseSuccess = 1;
-          Serial.println("早期检测：成功解析协议帧，提前结束捕获");
+        FrameDecodeInfo info;
+        frameDecodeInfoReset(&info);
+        if (parseProtocolFrame(g_rawBuf, g_rawLen, g_frameScratch, &info)) {
+          logDecodeInfo(info);
+          publishFrame(g_frameScratch, info.envTemp);
+          frameParseSuccess = 1;
+          MLX_LOGLN("早期检测：成功解析协议帧，提前结束捕获");
           break;
         }
       }
-      if (binBuf.size() >= 8192) break; // 安全上限
     }
-    if (MLX_EARLY_STOP_ENABLED && frameFound) break;
+    if (g_rawLen >= MLX_RAW_BUF_SIZE) break; // 缓冲已满
     delay(2);
   }
-  Serial.printf("窗口结束，收到字节: %u (binary)\n", (unsigned)binBuf.size());
-  if (binBuf.size() < 20) {
-    Serial.println("数据太少，可能未输出或波特率不匹配/模块未进入UART模式");
+  if (g_rawLen > g_rawHighWater) g_rawHighWater = g_rawLen;
+  MLX_LOG("窗口结束，收到字节: %u (binary)\n", (unsigned)g_rawLen);
+  if (g_rawLen < 20) {
+    MLX_LOGLN("数据太少，可能未输出或波特率不匹配/模块未进入UART模式");
     return false;
   }
-  Serial.println("前120字符: ");
-  Serial.println(g_rawData.substring(0, min(120, (int)g_rawData.length())));
-
-  // 二进制猜测：是否接近 768 * 2 = 1536 字节（每像素 16bit）或其倍数
-  size_t len = binBuf.size();
-  if (len >= 1536 && len % 256 == 0) {
-    Serial.println("尝试二进制帧解析模式 (16-bit per pixel)...");
-    // 尝试小端和大端两种方式
-    auto tryDecode = [&](bool littleEndian) -> bool {
-      size_t pixels = len / 2; // 假定全是像素
-      if (pixels < 768) return false;
-      size_t used = 768; // 只取前768像素
-      for (size_t i = 0; i < used; i++) {
-        uint8_t b1 = g_rawData[2*i];
-        uint8_t b2 = g_rawData[2*i + 1];
-        uint16_t raw = littleEndian ? (b2 << 8 | b1) : (b1 << 8 | b2);
-        // 粗略转换：许多红外阵列原始值可能对应开氏度*100 或摄氏度*100
-        float tempC = (float)raw / 100.0f; // 初步假设
-        // 过滤异常值
-        if (tempC < -60 || tempC > 400) {
-          // 尝试另一种缩放：/16
-          tempC = (float)raw / 16.0f; 
-        }
-        frame[i] = tempC;
-      }
-      // 简单合理性检查：计算范围
-      float mn = frame[0], mx = frame[0];
-      for (int i = 1; i < 768; ++i) { if (frame[i] < mn) mn = frame[i]; if (frame[i] > mx) mx = frame[i]; }
-      Serial.printf("解析方式(%s endian) 温度范围: %.2f .. %.2f\n", littleEndian?"little":"big", mn, mx);
-      // 判定是否合理：范围在 -50..350 且差值 > 1
-      if (mn > -55 && mx < 360 && (mx - mn) > 1) {
-        Serial.println("二进制解析成功！");
-        return true;
-      }
-      return false;
-    };
-    bool ok = tryDecode(true) || tryDecode(false);
-    if (ok) {
-      return true;
-    } else {
-      Serial.println("二进制解析失败，继续文本解析...");
+  if (g_verbose) {
+    // 预览前120字节，不可打印字符替换为 '.'，避免原始二进制混入串口文本
+    Serial.println("前120字符: ");
+    for (size_t i = 0; i < min<size_t>(120, g_rawLen); ++i) {
+      char ch = (char)g_rawBuf[i];
+      Serial.print((ch < 32 || ch > 126) ? '.' : ch);
     }
+    Serial.println();
   }
 
-  // 如果早期已成功解析协议帧
+  // 如果早期已成功解析协议帧（已在检测时发布）
   if (frameParseSuccess) {
     return true;
   }
-  // 协议帧解析尝试（可能在较小缓冲中没有满帧）
-  if (parseProtocolFrame(g_rawData)) {
-    Serial.println("协议帧解析成功 (后期) ");
+  // 完整解码流程（二进制猜测 -> 协议帧 -> 文本），结果先写入解码工作槽
+  FrameDecodeInfo info;
+  bool decoded = decodeCapture(g_rawBuf, g_rawLen, frame, g_frameScratch, &info);
+  logDecodeInfo(info);
+  if (decoded) {
+    // 只有协议帧带模块温度；二进制 / 文本模式保持原环境温度
+    publishFrame(g_frameScratch, info.source == FRAME_SRC_PROTOCOL ? info.envTemp : g_envTemp);
     return true;
   }
-  if (parseGYMCUData(g_rawData)) { // 次级文本尝试
-    Serial.println("文本/混合格式解析成功");
-    return true;
-  }
-  Serial.println("所有解析失败，使用模拟数据");
-  generateTestData();
   analyzeRawForPattern();
+#if MLX_SIMULATE_ON_FAIL
+  MLX_LOGLN("所有解析失败，发布模拟数据");
+  generateTestData(g_frameScratch);
+  publishFrame(g_frameScratch, NAN);
+  g_frameSimulated = true;
   return true;
+#else
+  // 拒绝本次捕获：已发布的 frame[] / g_envTemp 保持不变
+  MLX_LOGLN("所有解析失败，保留上一帧");
+  return false;
+#endif
 }
 
-// 解析GYMCU90640数据
-bool parseGYMCUData(String data) {
-  // GYMCU90640可能的数据格式:
-  // 1. 十六进制格式
-  // 2. 逗号分隔的十进制
-  // 3. 固定长度二进制数据
-  // 4. 带帧头的格式
-  
-  int validCount = 0;
-  
-  // 尝试解析十六进制格式 (常见于GYMCU模块)
-  if (data.indexOf("0x") >= 0 || data.length() > 1000) {
-    // 可能是十六进制数据
-    for (int i = 0; i < data.length() - 3 && validCount < 768; i++) {
-      if (data.charAt(i) == '0' && data.charAt(i+1) == 'x') {
-        String hexStr = data.substring(i+2, i+6); // 读取4位十六进制
-        if (hexStr.length() == 4) {
-          int hexVal = strtol(hexStr.c_str(), NULL, 16);
-          frame[validCount] = (float)hexVal / 100.0 - 273.15; // 转换为摄氏度
-          validCount++;
-          i += 5; // 跳过已处理的字符
-        }
-      }
+// 输出解码诊断（解码器本身不打印）
+void logDecodeInfo(const FrameDecodeInfo &info) {
+  if (info.candidates > 0) {
+    MLX_LOG("协议帧头在 %u, 声明长度=%u, 候选 %u 个\n",
+            (unsigned)info.start, info.declaredLen, info.candidates);
+    if (!isnan(info.envTemp)) {
+      MLX_LOG("模块温度: %.2fC, 校验=0x%04X, 累加和=0x%04X (%s)\n",
+              info.envTemp, info.checksum, info.sum16, info.checksumOK?"OK":"NG");
+    } else {
+      MLX_LOG("无模块温度字段, 校验=0x%04X, 累加和=0x%04X (%s)\n",
+              info.checksum, info.sum16, info.checksumOK?"OK":"NG");
     }
+    if (info.strictRejected) MLX_LOGLN("严格模式：校验失败拒绝帧");
   }
-  
-  // 尝试解析逗号分隔格式
-  if (validCount < 100) {
-    validCount = 0;
-    int startPos = 0;
-    
-    for (int i = 0; i < data.length() && validCount < 768; i++) {
-      if (data.charAt(i) == ',' || data.charAt(i) == ' ' || 
-          data.charAt(i) == '\n' || i == data.length() - 1) {
-        String tempStr = data.substring(startPos, i);
-        tempStr.trim();
-        
-        if (tempStr.length() > 0 && isDigit(tempStr.charAt(0))) {
-          float temp = tempStr.toFloat();
-          if (temp > -50 && temp < 150) { // 合理的温度范围
-            frame[validCount] = temp;
-            validCount++;
-          }
-        }
-        startPos = i + 1;
-      }
-    }
+  if (!isnan(info.minC)) {
+    MLX_LOG("像素温度范围%s: %.2f .. %.2f (Δ=%.2f)\n", info.kelvinAdjusted ? "(K->C调整后)" : "",
+            info.minC, info.maxC, info.maxC - info.minC);
+  }
+  switch (info.source) {
+    case FRAME_SRC_PROTOCOL:  MLX_LOGLN("协议帧解析成功"); break;
+    case FRAME_SRC_BINARY_LE: MLX_LOGLN("二进制解析成功 (little endian)"); break;
+    case FRAME_SRC_BINARY_BE: MLX_LOGLN("二进制解析成功 (big endian)"); break;
+    case FRAME_SRC_TEXT:      MLX_LOG("文本/混合格式解析成功, 有效温度值 %d 个\n", info.validCount); break;
+    default:                  MLX_LOG("解析失败 (文本有效值 %d 个)\n", info.validCount); break;
   }
-  
-  Serial.printf("解析到 %d 个有效温度值\n", validCount);
-  
-  return validCount >= 400; // 至少要有一半的数据
 }
 
 // 生成测试数据（用于调试）
-void generateTestData() {
+void generateTestData(int16_t *out) {
   float baseTemp = 25.0; // 基础温度
   
   for (int h = 0; h < 24; h++) {
@@ -404,7 +633,7 @@ void generateTestData() {
       float distance = sqrt((w - centerX) * (w - centerX) + (h - centerY) * (h - centerY));
       
       // 中心更热的分布
-      frame[index] = baseTemp + 10.0 * exp(-distance / 8.0) + random(-100, 100) / 100.0;
+      out[index] = toCenti(baseTemp + 10.0 * exp(-distance / 8.0) + random(-100, 100) / 100.0);
     }
   }
 }
@@ -418,13 +647,15 @@ void displaySimpleHeatmap() {
   }
   
   // 计算温度范围用于映射颜色
-  float minTemp = frame[0];
-  float maxTemp = frame[0];
+  int16_t minC = frame[0];
+  int16_t maxC = frame[0];
   
   for (int i = 1; i < 768; i++) {
-    if (frame[i] < minTemp) minTemp = frame[i];
-    if (frame[i] > maxTemp) maxTemp = frame[i];
+    if (frame[i] < minC) minC = frame[i];
+    if (frame[i] > maxC) maxC = frame[i];
   }
+  float minTemp = centiToC(minC);
+  float maxTemp = centiToC(maxC);
   
   float tempRange = maxTemp - minTemp;
   
@@ -438,7 +669,7 @@ void displaySimpleHeatmap() {
     for (int w = 0; w < 32; w++) {
   // 协议列顺序 Col1 为右上开始 -> 需要水平翻转
   int index = h * 32 + (31 - w);
-      float temp = frame[index];
+      float temp = centiToC(frame[index]);
       
       // 温度映射到颜色 (蓝色-绿色-红色)
       uint16_t color;
@@ -486,7 +717,7 @@ uint32_t scanBaud() {
   for (auto &c : cands) {
     mlxSerial.end();
     delay(50);
-    mlxSerial.begin(c.baud, SERIAL_8N1, MLX_RX_PIN, MLX_TX_PIN);
+    mlxBegin(c.baud);
     // 采样 250ms
     uint32_t t0 = millis();
     uint16_t count = 0;
@@ -497,7 +728,7 @@ uint32_t scanBaud() {
       }
     }
     c.bytes = count;
-    Serial.printf("  波特率 %lu 收到字节 %u\n", (unsigned long)c.baud, count);
+    serialPrintf("  波特率 %lu 收到字节 %u\n", (unsigned long)c.baud, count);
   }
   // 选最大
   Candidate best = cands[0];
@@ -508,27 +739,27 @@ uint32_t scanBaud() {
     Serial.println("未检测到任何数据，采用默认9600");
     return MLX_BAUDRATE_DEFAULT;
   }
-  Serial.printf("波特率扫描完成，选取 %lu (bytes=%u)\n", (unsigned long)best.baud, best.bytes);
+  serialPrintf("波特率扫描完成，选取 %lu (bytes=%u)\n", (unsigned long)best.baud, best.bytes);
   return best.baud;
 }
 
 // 输出原始数据前 n 字节（十六进制 + 可打印字符）
 void dumpRaw(uint16_t n) {
-  if (g_rawData.length() == 0) {
+  if (g_rawLen == 0) {
     Serial.println("无原始数据可输出，先按A短按采集一帧。");
     return;
   }
-  uint16_t len = min<uint16_t>(n, g_rawData.length());
-  Serial.printf("---- RAW HEX (len=%u) ----\n", len);
+  uint16_t len = (uint16_t)min<size_t>(n, g_rawLen);
+  serialPrintf("---- RAW HEX (len=%u) ----\n", len);
   for (uint16_t i = 0; i < len; ++i) {
-    uint8_t b = (uint8_t)g_rawData[i];
-    Serial.printf("%02X ", b);
+    uint8_t b = g_rawBuf[i];
+    serialPrintf("%02X ", b);
     if ((i+1) % 32 == 0) Serial.println();
   }
   Serial.println();
   Serial.println("---- RAW ASCII ----");
   for (uint16_t i = 0; i < len; ++i) {
-    char ch = g_rawData[i];
+    char ch = (char)g_rawBuf[i];
     if (ch < 32 || ch > 126) ch = '.';
     Serial.print(ch);
   }
@@ -536,150 +767,348 @@ void dumpRaw(uint16_t n) {
   Serial.println("-------------------");
 }
 
+// 导出完整原始捕获：每行 64 字节纯十六进制，首尾带标记行便于上位机截取
+void dumpCapture() {
+  serialPrintf("---- CAPTURE BEGIN len=%u ----\n", (unsigned)g_rawLen);
+  for (size_t i = 0; i < g_rawLen; ++i) {
+    serialPrintf("%02X", g_rawBuf[i]);
+    if ((i+1) % 64 == 0 || i + 1 == g_rawLen) Serial.println();
+  }
+  Serial.println("---- CAPTURE END ----");
+}
+
 // 分析原始数据中可能的模式（例如 0x5A 填充/定界）
 void analyzeRawForPattern() {
-  if (g_rawData.length() == 0) {
-    Serial.println("无原始数据可分析");
+  if (g_rawLen == 0) {
+    MLX_LOGLN("无原始数据可分析");
     return;
   }
-  size_t len = g_rawData.length();
+  size_t len = g_rawLen;
   uint32_t count5A = 0;
   uint32_t count00 = 0;
   for (size_t i = 0; i < len; ++i) {
-    uint8_t b = (uint8_t)g_rawData[i];
+    uint8_t b = g_rawBuf[i];
     if (b == 0x5A) count5A++;
     if (b == 0x00) count00++;
   }
-  Serial.printf("模式分析: 总字节=%u, 0x5A出现=%u (%.2f%%), 0x00出现=%u (%.2f%%)\n",
-                (unsigned)len, count5A, 100.0*count5A/len, count00, 100.0*count00/len);
-  // 去掉0x5A再尝试按16位解析
-  String filtered;
-  filtered.reserve(len);
-  for (size_t i = 0; i < len; ++i) {
-    uint8_t b = (uint8_t)g_rawData[i];
-    if (b != 0x5A) filtered += (char)b;
-  }
-  size_t flen = filtered.length();
-  Serial.printf("过滤0x5A后字节数=%u\n", (unsigned)flen);
+  MLX_LOG("模式分析: 总字节=%u, 0x5A出现=%u (%.2f%%), 0x00出现=%u (%.2f%%)\n",
+          (unsigned)len, count5A, 100.0*count5A/len, count00, 100.0*count00/len);
+  // 去掉0x5A再尝试按16位解析（只需长度，无需复制过滤后的数据）
+  size_t flen = len - count5A;
+  MLX_LOG("过滤0x5A后字节数=%u\n", (unsigned)flen);
   if (flen >= 1536) {
     size_t pixels = flen / 2;
-    Serial.printf("可能像素(过滤后按2字节/像素)= %u\n", (unsigned)pixels);
-  }
-}
-
-// 按照协议：帧长度1544字节：
-// [0]=0x5A [1]=0x5A [2]=lenLow [3]=lenHigh (期望 0x02 0x06 => 0x0602=1538? 或 0x0206=518?)
-// 接着 1536 字节像素数据 (每像素1字节? 文档里目标温度数据1低8位、高8位 -> 2字节/像素 => 1536/2=768 像素 OK)
-// 然后 2 字节模块自身温度 (低/高) + 2 字节校验
-// 实际示例：总字节 1544 = 2(头) +2(长度)+1536(像素数据)+2(模块温度)+2(校验) = 1544
-// 像素逻辑：每像素两个连续字节组成 16bit 原始值；需转换为摄氏温度（暂时 raw/100）
-bool parseProtocolFrame(const String &raw) {
-  // 新解析逻辑：声明长度字段(declaredLen) = 像素数据(2*768=1536) + 模块温度(2) = 1538
-  // 完整帧总长度 = 2(帧头) + 2(长度) + declaredLen(1538) + 2(校验) = 1544
-  const uint16_t EXPECT_PIXEL_COUNT = 768;
-  // 支持的 declaredLen 备选：
-  // 1538 = 像素(1536) + 模块温度(2) 不含校验
-  // 1536 = 仅像素数据 (可能模块温度单独或缺失)
-  // 1540 = 像素(1536) + 模块温度(2) + 校验前2?（某些文档差异）
-  const uint16_t ALT_DECLARED[3] = {1538, 1536, 1540};
-  const size_t RAW_LEN = raw.length();
-  // 计算一个最小帧需求（使用最小的 declaredLen=1536 -> 总=2+2+1536+2=1542）
-  const uint16_t MIN_FRAME_TOTAL = 2 + 2 + 1536 + 2; // 使用最小估计
-  size_t rawLen = raw.length();
-  if (rawLen < MIN_FRAME_TOTAL) return false;
-
-  // 扫描整个缓冲寻找可能的帧头
-  for (size_t start = 0; start + MIN_FRAME_TOTAL <= rawLen; ++start) {
-    if ((uint8_t)raw[start] != 0x5A || (uint8_t)raw[start+1] != 0x5A) continue;
-    uint8_t b2 = (uint8_t)raw[start+2];
-    uint8_t b3 = (uint8_t)raw[start+3];
-    uint16_t declaredLen = (uint16_t)b3 * 256 + b2; // 低在前（协议特殊顺序）
-    bool lenSupported = false;
-    for (auto v : ALT_DECLARED) { if (declaredLen == v) { lenSupported = true; break; } }
-    if (!lenSupported) continue; // 尝试下一处帧头
-    size_t pixelDataOffset = start + 4; // 像素数据开始
-    size_t pixelBytes = EXPECT_PIXEL_COUNT * 2; // 固定 1536
-    size_t moduleTempOffset = pixelDataOffset + pixelBytes; // 模块温度2字节位置
-    // 校验位置：若 declaredLen 包含模块温度，则校验在其后两个字节；若不包含模块温度则需要调整
-    bool hasModuleTemp = (declaredLen >= 1538); // 当1536时可能没有模块温度
-    bool hasModuleTempExplicit = (declaredLen == 1538 || declaredLen == 1540);
-    if (!hasModuleTempExplicit) {
-      // 没有明确模块温度时，将环境温度设为 NAN
-      g_envTemp = NAN;
-    }
-    size_t checksumOffset;
-    if (declaredLen == 1536) {
-      // 帧结构：2(头)+2(len)+1536(像素)+2(校验) 总 1542
-      checksumOffset = pixelDataOffset + pixelBytes; // 紧随像素
-    } else if (declaredLen == 1538) {
-      // 2+2+1536+2(模块温度)+2(校验)=1544
-      checksumOffset = moduleTempOffset + 2;
-    } else { // 1540 假设：像素1536 + 模块温度2 + 额外填充2? + 校验2 => 总 2+2+1540+2=1546
-      checksumOffset = pixelDataOffset + declaredLen; // declaredLen全部数据之后
-    }
-    if (checksumOffset + 2 > rawLen) {
-      // 缓冲不足，放弃本帧
-      continue;
-    }
-    Serial.printf("协议帧头在 %u, 声明长度=%u (支持)\n", (unsigned)start, declaredLen);
-    // 解析像素 (16-bit 小端)
-    for (uint16_t px = 0; px < EXPECT_PIXEL_COUNT; ++px) {
-      uint8_t lo = (uint8_t)raw[pixelDataOffset + px*2];
-      uint8_t hi = (uint8_t)raw[pixelDataOffset + px*2 + 1];
-      uint16_t v = (uint16_t)hi << 8 | lo;
-      float tempC = v / 100.0f; // 默认缩放
-      if (tempC < -60 || tempC > 400) tempC = v / 16.0f; // 异常值备用方案
-      frame[px] = tempC;
-    }
-    // 模块环境温度
-    float moduleTemp = NAN;
-    if (declaredLen != 1536) { // 有模块温度字段
-      uint8_t mLo = (uint8_t)raw[moduleTempOffset];
-      uint8_t mHi = (uint8_t)raw[moduleTempOffset+1];
-      uint16_t moduleRaw = (uint16_t)mHi << 8 | mLo;
-      moduleTemp = moduleRaw / 100.0f;
-      g_envTemp = moduleTemp;
-    }
-    // 校验
-    uint8_t chkLo = (uint8_t)raw[checksumOffset];
-    uint8_t chkHi = (uint8_t)raw[checksumOffset+1];
-    uint16_t chk = (uint16_t)chkHi << 8 | chkLo;
-    uint32_t sum = 0;
-    size_t sumEnd = (declaredLen == 1536) ? (pixelDataOffset + pixelBytes) : (declaredLen == 1538 ? (moduleTempOffset + 2) : (pixelDataOffset + declaredLen));
-    for (size_t i = start; i < sumEnd; ++i) {
-      sum += (uint8_t)raw[i];
+    MLX_LOG("可能像素(过滤后按2字节/像素)= %u\n", (unsigned)pixels);
+  }
+}
+
+// 启动时一次性分配历史帧环：优先 PSRAM（大块冷数据），失败则退回内部 SRAM
+bool poolInit() {
+  const size_t bytes = (size_t)MLX_HISTORY_FRAMES * FRAME_SIZE * sizeof(int16_t);
+  g_history = (int16_t *)heap_caps_calloc(1, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  g_historyInPsram = (g_history != nullptr);
+  if (!g_history) {
+    g_history = (int16_t *)heap_caps_calloc(1, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  }
+  g_historyHead = 0;
+  g_historyCount = 0;
+  serialPrintf("内存池: 帧=%u B 原始=%u B (内部SRAM), 历史=%u B (%s)\n",
+                (unsigned)sizeof(frame), (unsigned)sizeof(g_rawBuf), (unsigned)bytes,
+                g_history ? (g_historyInPsram ? "PSRAM" : "内部SRAM") : "未分配");
+  return g_history != nullptr;
+}
+
+// 发布已接受的帧：复制到 frame[]、更新环境温度并写入历史
+void publishFrame(const int16_t *src, float envTemp) {
+  if (src != frame) memcpy(frame, src, sizeof(frame));
+  g_envTemp = envTemp;
+  pushHistory();
+}
+
+// 将当前帧写入历史帧环（覆盖最旧一帧）
+void pushHistory() {
+  if (!g_history) return;
+  memcpy(g_history + (size_t)g_historyHead * FRAME_SIZE, frame, sizeof(frame));
+  g_historyHead = (g_historyHead + 1) % MLX_HISTORY_FRAMES;
+  if (g_historyCount < MLX_HISTORY_FRAMES) g_historyCount++;
+}
+
+// 历史帧摘要：从旧到新逐帧输出 min/max/avg/center，并给出中心点的时间平均
+void printHistory() {
+  if (!g_history || g_historyCount == 0) {
+    Serial.println("历史帧为空");
+    return;
+  }
+  serialPrintf("---- 历史帧 (%u/%u, 单位 °C) ----\n", g_historyCount, (unsigned)MLX_HISTORY_FRAMES);
+  const int centerIndex = 16 * 24 + 12; // 与屏幕显示的中心点一致
+  int32_t centerSum = 0;
+  uint16_t oldest = (g_historyHead + MLX_HISTORY_FRAMES - g_historyCount) % MLX_HISTORY_FRAMES;
+  for (uint16_t k = 0; k < g_historyCount; ++k) {
+    const int16_t *h = g_history + (size_t)((oldest + k) % MLX_HISTORY_FRAMES) * FRAME_SIZE;
+    int16_t mn = h[0], mx = h[0];
+    int32_t sum = 0;
+    for (int i = 0; i < FRAME_SIZE; ++i) {
+      if (h[i] < mn) mn = h[i];
+      if (h[i] > mx) mx = h[i];
+      sum += h[i];
     }
-    uint16_t sum16 = (uint16_t)(sum & 0xFFFF);
-    bool checksumOK = (chk == sum16);
-    if (!isnan(moduleTemp)) {
-      Serial.printf("模块温度: %.2fC, 校验=0x%04X, 累加和=0x%04X (%s)\n", moduleTemp, chk, sum16, checksumOK?"OK":"NG");
-    } else {
-      Serial.printf("无模块温度字段, 校验=0x%04X, 累加和=0x%04X (%s)\n", chk, sum16, checksumOK?"OK":"NG");
+    centerSum += h[centerIndex];
+    serialPrintf("#%2u min %.2f max %.2f avg %.2f center %.2f\n", k,
+                  centiToC(mn), centiToC(mx), centiToC((int16_t)(sum / FRAME_SIZE)), centiToC(h[centerIndex]));
+  }
+  serialPrintf("中心点时间平均: %.2f\n", centerSum / 100.0f / g_historyCount);
+  Serial.println("------------------");
+}
+
+// 内存报告：缓冲布局、高水位、setup() 之后的净常驻堆增量与分配次数
+void printMemReport() {
+  // 先取快照，报告自身的输出不计入
+  multi_heap_info_t now;
+  heap_caps_get_info(&now, MALLOC_CAP_8BIT);
+  uint32_t allocCount = g_allocCount, allocBytes = g_allocBytes;
+  uintptr_t firstCaller = g_allocFirstCaller;
+  Serial.println("---- 内存报告 ----");
+  serialPrintf("帧缓冲: %u B (int16 厘摄氏度, 内部SRAM)\n", (unsigned)sizeof(frame));
+  serialPrintf("原始缓冲: %u B, 高水位 %u B (内部SRAM)\n",
+                (unsigned)sizeof(g_rawBuf), (unsigned)g_rawHighWater);
+  serialPrintf("历史帧环: %u x %u B (%s), 已存 %u 帧\n",
+                (unsigned)MLX_HISTORY_FRAMES, (unsigned)sizeof(frame),
+                g_history ? (g_historyInPsram ? "PSRAM" : "内部SRAM") : "未分配", g_historyCount);
+  serialPrintf("内部堆: 空闲 %u B, 历史最低 %u B, 最大块 %u B\n",
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+                (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+                (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+  serialPrintf("PSRAM: 空闲 %u B, 历史最低 %u B\n",
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+                (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+  int dBlocks = (int)now.allocated_blocks - (int)g_bootHeap.allocated_blocks;
+  int dBytes = (int)now.total_allocated_bytes - (int)g_bootHeap.total_allocated_bytes;
+  serialPrintf("JSON 固定区: %u B, 高水位 %u B, 分配失败 %u\n",
+                (unsigned)g_jsonArena.capacity(), (unsigned)g_jsonArena.highWater(),
+                (unsigned)g_jsonArena.failures());
+  serialPrintf("启动后净常驻增量: 块 %+d, 字节 %+d (不含已释放的临时分配)\n", dBlocks, dBytes);
+  if (allocCount == 0) {
+    Serial.println("启动后分配次数: 0");
+  } else {
+    serialPrintf("启动后分配次数: %u 次, 共 %u B, 首次调用方 0x%08lx\n",
+                  (unsigned)allocCount, (unsigned)allocBytes, (unsigned long)firstCaller);
+  }
+  Serial.println("------------------");
+}
+
+// USB 串口单字符命令
+//   m = 内存报告
+//   j = JSON 输出模式开/关
+//   s / e / p = 切换 JSON 字段: 统计 / 环境温度 / 像素数组
+//   b = JSON 序列化基准测试
+//   h = 历史帧摘要
+//   r = 导出最近一次完整原始捕获（纯十六进制，可用 xxd -r -p 还原为回归样本）
+void handleSerialCommand() {
+  while (Serial.available()) {
+    int c = Serial.read();
+    switch (c) {
+      case 'm': case 'M': printMemReport(); break;
+      case 'j': case 'J':
+        g_jsonMode = !g_jsonMode;
+        g_verbose = !g_jsonMode; // JSON 模式下关闭调试日志
+        if (g_jsonMode) startJsonStream();
+        printJsonConfig();
+        break;
+      case 's': case 'S': g_jsonFields ^= JSON_F_STATS;  printJsonConfig(); break;
+      case 'e': case 'E': g_jsonFields ^= JSON_F_ENV;    printJsonConfig(); break;
+      case 'p': case 'P': g_jsonFields ^= JSON_F_PIXELS; printJsonConfig(); break;
+      case 'b': case 'B': benchJson(); break;
+      case 'h': case 'H': printHistory(); break;
+      case 'r': case 'R': dumpCapture(); break;
+      default: break;
     }
-    // 像素范围统计
-    float mn = frame[0], mx = frame[0];
-    for (uint16_t i=1;i<EXPECT_PIXEL_COUNT;++i){ if(frame[i]<mn) mn=frame[i]; if(frame[i]>mx) mx=frame[i]; }
-    Serial.printf("像素温度范围: %.2f .. %.2f (Δ=%.2f)\n", mn,mx,mx-mn);
-    // 合理性判定
-    bool valueOK = (mn > -55 && mx < 360 && (mx - mn) > 0.5);
-    if (!valueOK) {
-      // 再尝试开氏度->摄氏度转换
-      for (uint16_t i=0;i<EXPECT_PIXEL_COUNT;++i) frame[i] = frame[i] - 273.15f;
-      mn = frame[0]; mx = frame[0];
-      for (uint16_t i=1;i<EXPECT_PIXEL_COUNT;++i){ if(frame[i]<mn) mn=frame[i]; if(frame[i]>mx) mx=frame[i]; }
-      Serial.printf("K->C调整后范围: %.2f .. %.2f (Δ=%.2f)\n", mn,mx,mx-mn);
-      valueOK = (mn > -55 && mx < 360 && (mx - mn) > 0.5);
+  }
+}
+
+// 回显 JSON 配置：JSON 模式下本身也是一行 JSON，不破坏 NDJSON 流
+void printJsonConfig() {
+  if (g_jsonMode) {
+    serialPrintf("{\"type\":\"config\",\"fields\":%u,\"interval_ms\":%u}\n",
+                  g_jsonFields, (unsigned)MLX_JSON_MIN_INTERVAL_MS);
+  } else {
+    serialPrintf("JSON 输出: OFF (字段=0x%02X)\n", g_jsonFields);
+  }
+}
+
+// 用当前 frame[] 填充 g_jsonDoc（固定区，不触碰堆）
+void buildJsonFrame(uint8_t fields) {
+  g_jsonDoc.clear();
+  g_jsonArena.reset();
+  g_jsonDoc["type"] = "frame";
+  g_jsonDoc["seq"] = g_jsonSeq;
+  g_jsonDoc["ms"] = millis();
+  g_jsonDoc["scale"] = 100;
+  if (g_frameSimulated) g_jsonDoc["sim"] = true;
+  if (fields & JSON_F_STATS) {
+    int16_t mn = frame[0], mx = frame[0];
+    int32_t sum = 0;
+    for (int i = 0; i < FRAME_SIZE; ++i) {
+      if (frame[i] < mn) mn = frame[i];
+      if (frame[i] > mx) mx = frame[i];
+      sum += frame[i];
     }
-    if (valueOK) {
-      if (USE_STRICT_PROTOCOL && !checksumOK) {
-        Serial.println("严格模式：校验失败拒绝帧");
-        return false;
-      }
-      return true; // 成功解析
-    } else {
-      Serial.println("数值不合理，继续寻找下一帧...");
-      continue; // 尝试后续帧
+    g_jsonDoc["min"] = mn;
+    g_jsonDoc["max"] = mx;
+    g_jsonDoc["avg"] = (int32_t)(sum / FRAME_SIZE);
+    g_jsonDoc["center"] = frame[16 * 24 + 12]; // 与屏幕显示的中心点一致
+  }
+  if ((fields & JSON_F_ENV) && !isnan(g_envTemp)) {
+    g_jsonDoc["env"] = toCenti(g_envTemp);
+  }
+  if (fields & JSON_F_PIXELS) {
+    JsonArray px = g_jsonDoc["px"].to<JsonArray>();
+    for (int i = 0; i < FRAME_SIZE; ++i) px.add(frame[i]);
+  }
+}
+
+// 把 g_jsonDoc 写成一行；固定区溢出或发送缓冲不足一整行时丢弃而不是阻塞
+bool emitJsonLine() {
+  if (g_jsonDoc.overflowed()) {
+    g_jsonOverflow++;
+    return false;
+  }
+  size_t need = measureJson(g_jsonDoc) + 1; // 含换行
+  if ((size_t)Serial.availableForWrite() < need) {
+    g_jsonDropped++;
+    return false;
+  }
+  SerialChunkWriter out;
+  serializeJson(g_jsonDoc, out);
+  out.write('\n');
+  out.flush();
+  return true;
+}
+
+// 按速率限制输出一帧 JSON
+void emitJsonFrame() {
+  uint32_t now = millis();
+  if (!g_jsonPacer.due(now)) {
+    g_jsonSkipped++;
+    return;
+  }
+  g_jsonSeq++;
+  buildJsonFrame(g_jsonFields);
+  if (!emitJsonLine()) return;
+  g_jsonPacer.sent(now);
+  g_jsonSent++;
+}
+
+// 每个统计窗口输出一行实际帧率：
+// {"type":"rate","ms":窗口时长,"in":采集帧,"out":已发送,"skipped":限速跳过,"dropped":缓冲不足,"overflow":固定区溢出}
+void emitJsonRate() {
+  uint32_t now = millis();
+  uint32_t win = now - g_rateWin.startMs;
+  if (win < MLX_JSON_RATE_WINDOW_MS) return;
+  g_rateLast.startMs = win;
+  g_rateLast.in = g_streamFramesIn - g_rateWin.in;
+  g_rateLast.sent = g_jsonSent - g_rateWin.sent;
+  g_rateLast.skipped = g_jsonSkipped - g_rateWin.skipped;
+  g_rateLast.dropped = g_jsonDropped - g_rateWin.dropped;
+  g_rateLast.overflow = g_jsonOverflow - g_rateWin.overflow;
+  g_rateWin = {now, g_streamFramesIn, g_jsonSent, g_jsonSkipped, g_jsonDropped, g_jsonOverflow};
+  g_jsonDoc.clear();
+  g_jsonArena.reset();
+  g_jsonDoc["type"] = "rate";
+  g_jsonDoc["ms"] = g_rateLast.startMs;
+  g_jsonDoc["in"] = g_rateLast.in;
+  g_jsonDoc["out"] = g_rateLast.sent;
+  g_jsonDoc["skipped"] = g_rateLast.skipped;
+  g_jsonDoc["dropped"] = g_rateLast.dropped;
+  g_jsonDoc["overflow"] = g_rateLast.overflow;
+  emitJsonLine();
+}
+
+// 进入 JSON 模式：清空捕获缓冲，重置速率窗口
+void startJsonStream() {
+  g_rawLen = 0;
+  g_jsonPacer.reset();
+  g_streamDirty = false;
+  g_rateWin = {(uint32_t)millis(), g_streamFramesIn, g_jsonSent, g_jsonSkipped, g_jsonDropped, g_jsonOverflow};
+}
+
+// 从捕获缓冲头部丢弃 n 字节，剩余数据可能已含下一帧，标记为需要重新解析
+static void streamConsume(size_t n) {
+  memmove(g_rawBuf, g_rawBuf + n, g_rawLen - n);
+  g_rawLen -= n;
+  g_streamDirty = true;
+}
+
+// 滚动采集：非阻塞地把已到达的 UART 数据追加到捕获缓冲，缓冲跨调用保留；
+// 解析出协议帧后发布，并丢弃帧尾之前的字节，后续数据继续留在缓冲里
+bool pollStreamFrame() {
+  int avail = mlxSerial.available();
+  if (avail > 0 && g_rawLen < MLX_RAW_BUF_SIZE) {
+    size_t n = mlxSerial.read(g_rawBuf + g_rawLen, min<size_t>(avail, MLX_RAW_BUF_SIZE - g_rawLen));
+    g_rawLen += n;
+    if (g_rawLen > g_rawHighWater) g_rawHighWater = g_rawLen;
+    if (n > 0) g_streamDirty = true;
+  }
+  if (!g_streamDirty || g_rawLen < MLX_PROTOCOL_MIN_FRAME) return false;
+  g_streamDirty = false;
+
+  FrameDecodeInfo info;
+  frameDecodeInfoReset(&info);
+  if (parseProtocolFrame(g_rawBuf, g_rawLen, g_frameScratch, &info)) {
+    publishFrame(g_frameScratch, info.envTemp);
+    g_frameSimulated = false;
+    g_streamFramesIn++;
+    streamConsume(info.start + info.frameLen);
+    return true;
+  }
+  // 严格模式在第一个校验失败的帧处就返回：丢弃该帧，否则后面的好帧会一直堵在它后面
+  if (info.strictRejected) {
+    g_streamStrictRejected++;
+    streamConsume(info.start + info.frameLen);
+    return false;
+  }
+  // 缓冲已满仍无有效帧：只保留末尾不足一帧的数据（可能是下一帧的开头）
+  if (g_rawLen >= MLX_RAW_BUF_SIZE) {
+    size_t keep = MLX_PROTOCOL_MAX_FRAME - 1;
+    memmove(g_rawBuf, g_rawBuf + g_rawLen - keep, keep);
+    g_rawLen = keep;
+  }
+  return false;
+}
+
+// 基准：构建与序列化耗时、每帧字节数（输出到计数写入器，不占串口带宽）
+void benchJson() {
+  const int N = 32;
+  const uint8_t modes[2] = {JSON_F_STATS | JSON_F_ENV, JSON_F_STATS | JSON_F_ENV | JSON_F_PIXELS};
+  Serial.println("---- JSON 基准 ----");
+  for (uint8_t fields : modes) {
+    uint32_t tBuild = 0, tMeasure = 0, tSerialize = 0;
+    size_t bytes = 0;
+    for (int i = 0; i < N; ++i) {
+      uint32_t t0 = micros();
+      buildJsonFrame(fields);
+      uint32_t t1 = micros();
+      bytes = measureJson(g_jsonDoc) + 1;
+      uint32_t t2 = micros();
+      NullJsonWriter sink;
+      serializeJson(g_jsonDoc, sink);
+      uint32_t t3 = micros();
+      tBuild += t1 - t0; tMeasure += t2 - t1; tSerialize += t3 - t2;
     }
+    serialPrintf("字段=0x%02X: 构建 %lu us, 测长 %lu us, 序列化 %lu us, %u B/帧 (8Hz=%lu B/s)%s\n",
+                  fields, (unsigned long)(tBuild / N), (unsigned long)(tMeasure / N),
+                  (unsigned long)(tSerialize / N), (unsigned)bytes, (unsigned long)(bytes * 8),
+                  g_jsonDoc.overflowed() ? " [固定区溢出]" : "");
   }
-  return false; // 未找到有效帧
-}
\ No newline at end of file
+  serialPrintf("已发送 %u, 限速跳过 %u, 缓冲不足丢弃 %u, 固定区溢出 %u, 严格模式拒绝 %u\n",
+                (unsigned)g_jsonSent, (unsigned)g_jsonSkipped, (unsigned)g_jsonDropped, (unsigned)g_jsonOverflow,
+                (unsigned)g_streamStrictRejected);
+  if (g_rateLast.startMs > 0) {
+    float sec = g_rateLast.startMs / 1000.0f;
+    serialPrintf("最近窗口 (%lu ms) 端到端: 采集 %.1f 帧/s, 发送 %.1f 帧/s, 丢弃 %.1f 帧/s\n",
+                  (unsigned long)g_rateLast.startMs, g_rateLast.in / sec, g_rateLast.sent / sec,
+                  (g_rateLast.dropped + g_rateLast.overflow) / sec);
+  } else {
+    Serial.println("端到端帧率: 尚无数据（先用 j 开启 JSON 模式运行至少 1 秒）");
+  }
+  Serial.println("-------------------");
+}
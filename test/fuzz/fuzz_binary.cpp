@@ -0,0 +1,23 @@
+// decodeBinaryFrame 模糊入口：小端 / 大端两种猜测都不得读出输入范围
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_parser.h"
+#include "fuzz_common.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  int16_t out[MLX_FRAME_PIXELS];
+  for (int le = 0; le < 2; le++) {
+    FrameDecodeInfo info;
+    frameDecodeInfoReset(&info);
+    bool ok = decodeBinaryFrame(data, size, le != 0, out, &info);
+    if (ok) {
+      FUZZ_CHECK(size >= (size_t)MLX_FRAME_PIXELS * 2);
+      FUZZ_CHECK(info.source == (le ? FRAME_SRC_BINARY_LE : FRAME_SRC_BINARY_BE));
+    } else {
+      FUZZ_CHECK(info.source == FRAME_SRC_NONE);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,25 @@
+// decodeCapture 模糊入口：模拟 readMLXFrame 的发布流程，
+// 被拒绝的捕获必须让已发布帧保持逐字节不变
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "frame_parser.h"
+#include "fuzz_common.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  int16_t published[MLX_FRAME_PIXELS];
+  int16_t snapshot[MLX_FRAME_PIXELS];
+  int16_t scratch[MLX_FRAME_PIXELS];
+  for (int i = 0; i < MLX_FRAME_PIXELS; i++) published[i] = (int16_t)(2000 + i);
+  memcpy(snapshot, published, sizeof(published));
+  memset(scratch, 0xA5, sizeof(scratch));
+
+  FrameDecodeInfo info;
+  bool ok = decodeCapture(data, size, published, scratch, &info);
+  FUZZ_CHECK(memcmp(published, snapshot, sizeof(published)) == 0);
+  FUZZ_CHECK(ok == (info.source != FRAME_SRC_NONE));
+  if (ok) memcpy(published, scratch, sizeof(published)); // publishFrame
+  return 0;
+}
@@ -0,0 +1,49 @@
+// 差分模糊入口：同一输入分别交给参考解码器 (baseline float 逻辑) 与 src/frame_parser.cpp，
+// 要求接受 / 拒绝与来源一致，接受时像素 (厘摄氏度) 与环境温度一致
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "frame_parser.h"
+#include "fuzz_common.h"
+#include "reference/frame_parser_ref.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  int16_t prev[MLX_FRAME_PIXELS];
+  float prevRef[MLX_FRAME_PIXELS];
+  for (int i = 0; i < MLX_FRAME_PIXELS; i++) {
+    prev[i] = (int16_t)(2000 + i);
+    prevRef[i] = centiToC(prev[i]);
+  }
+
+  int16_t cand[MLX_FRAME_PIXELS];
+  FrameDecodeInfo info;
+  bool ok = decodeCapture(data, size, prev, cand, &info);
+
+  float ref[MLX_FRAME_PIXELS];
+  float refEnv = NAN;
+  FrameSource refSrc = frame_parser_ref::decodeCapture(data, size, prevRef, ref, &refEnv);
+
+  if (info.source != refSrc) {
+    fprintf(stderr, "来源不一致: candidate=%d reference=%d\n", (int)info.source, (int)refSrc);
+  }
+  FUZZ_CHECK(info.source == refSrc);
+  FUZZ_CHECK(ok == (refSrc != FRAME_SRC_NONE));
+  if (!ok) return 0;
+
+  // 十六进制文本在 baseline 中以 double 计算后再转 float，量化时允许 1 厘度误差
+  int tol = (info.source == FRAME_SRC_TEXT) ? 1 : 0;
+  for (int i = 0; i < MLX_FRAME_PIXELS; i++) {
+    int diff = abs((int)cand[i] - (int)toCenti(ref[i]));
+    if (diff > tol) {
+      fprintf(stderr, "像素 %d 不一致: candidate=%d reference=%.4f\n", i, cand[i], ref[i]);
+    }
+    FUZZ_CHECK(diff <= tol);
+  }
+  if (info.source == FRAME_SRC_PROTOCOL) {
+    FUZZ_CHECK((isnan(info.envTemp) && isnan(refEnv)) || info.envTemp == refEnv);
+  }
+  return 0;
+}
@@ -0,0 +1,24 @@
+// parseProtocolFrame 模糊入口：任意字节不得越界；接受的帧必须完整落在输入内
+// (pollStreamFrame 按 start + frameLen 消费缓冲)
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_parser.h"
+#include "fuzz_common.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  int16_t out[MLX_FRAME_PIXELS];
+  FrameDecodeInfo info;
+  frameDecodeInfoReset(&info);
+  if (parseProtocolFrame(data, size, out, &info)) {
+    FUZZ_CHECK(info.source == FRAME_SRC_PROTOCOL);
+    FUZZ_CHECK(info.frameLen >= MLX_PROTOCOL_MIN_FRAME && info.frameLen <= MLX_PROTOCOL_MAX_FRAME);
+    FUZZ_CHECK(info.start + info.frameLen <= size);
+    FUZZ_CHECK(data[info.start] == 0x5A && data[info.start + 1] == 0x5A);
+    FUZZ_CHECK(info.minC > -55 && info.maxC < 360);
+  } else {
+    FUZZ_CHECK(info.source == FRAME_SRC_NONE);
+  }
+  return 0;
+}
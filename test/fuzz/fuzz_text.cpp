@@ -0,0 +1,18 @@
+// parseGYMCUData 模糊入口：文本扫描不得越界，有效值个数不超过一帧
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_parser.h"
+#include "fuzz_common.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  int16_t out[MLX_FRAME_PIXELS] = {};
+  FrameDecodeInfo info;
+  frameDecodeInfoReset(&info);
+  bool ok = parseGYMCUData(data, size, out, &info);
+  FUZZ_CHECK(info.validCount >= 0 && info.validCount <= MLX_FRAME_PIXELS);
+  FUZZ_CHECK(ok == (info.validCount >= 400));
+  FUZZ_CHECK(ok == (info.source == FRAME_SRC_TEXT));
+  return 0;
+}
@@ -0,0 +1,154 @@
+// 生成 test/corpus/ 下的合成种子 (syn_*)：结构与串口命令 r 导出的原始捕获一致
+// 用法: make_seeds <输出目录>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static uint32_t g_rng = 12345;
+
+static uint8_t noiseByte() {
+  g_rng = g_rng * 1103515245u + 12345u;
+  return (uint8_t)(g_rng >> 16);
+}
+
+// 厘摄氏度梯度画面：背景 baseC (°C)，中心热点 hotCenti (厘摄氏度)
+static uint16_t pixelValue(int i, int baseC, int hotCenti) {
+  int x = i % 32, y = i / 32;
+  int dx = x - 16, dy = y - 12;
+  int d2 = dx * dx + dy * dy;
+  return (uint16_t)(d2 < 16 ? hotCenti : baseC * 100 + x * 7 + y * 3);
+}
+
+static void putLE(Bytes &b, uint16_t v) {
+  b.push_back((uint8_t)(v & 0xFF));
+  b.push_back((uint8_t)(v >> 8));
+}
+
+// 协议帧：0x5A 0x5A lenLo lenHi + 像素 + [模块温度] + [填充] + 累加和
+static Bytes protocolFrame(uint16_t declaredLen, int baseC, int hotCenti, bool badChecksum = false) {
+  Bytes b = {0x5A, 0x5A};
+  putLE(b, declaredLen);
+  for (int i = 0; i < 768; i++) putLE(b, pixelValue(i, baseC, hotCenti));
+  if (declaredLen >= 1538) putLE(b, 2850);  // 模块温度 28.50°C
+  if (declaredLen == 1540) putLE(b, 0);
+  uint32_t sum = 0;
+  for (uint8_t v : b) sum += v;
+  putLE(b, (uint16_t)(sum + (badChecksum ? 1 : 0)));
+  return b;
+}
+
+static Bytes noise(size_t n) {
+  Bytes b;
+  for (size_t i = 0; i < n; i++) b.push_back(noiseByte());
+  return b;
+}
+
+static Bytes cat(std::initializer_list<Bytes> parts) {
+  Bytes out;
+  for (const auto &p : parts) out.insert(out.end(), p.begin(), p.end());
+  return out;
+}
+
+static Bytes text(const std::string &s) { return Bytes(s.begin(), s.end()); }
+
+static bool writeSeed(const std::string &dir, const char *name, const Bytes &b) {
+  std::string path = dir + "/" + name;
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f) {
+    fprintf(stderr, "无法写入 %s\n", path.c_str());
+    return false;
+  }
+  fwrite(b.data(), 1, b.size(), f);
+  fclose(f);
+  printf("%-36s %6zu 字节\n", name, b.size());
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    fprintf(stderr, "用法: %s <输出目录>\n", argv[0]);
+    return 2;
+  }
+  std::string dir = argv[1];
+
+  Bytes f1538 = protocolFrame(1538, 24, 3400);
+  Bytes flat;  // 全部像素相同：范围 < 0.5°C，应被拒绝
+  {
+    flat = {0x5A, 0x5A};
+    putLE(flat, 1538);
+    for (int i = 0; i < 768; i++) putLE(flat, 2500);
+    putLE(flat, 2850);
+    putLE(flat, 0);
+  }
+  Bytes lowContrast;  // 范围 0.55°C，刚好超过 0.5°C 的判定阈值
+  {
+    lowContrast = {0x5A, 0x5A};
+    putLE(lowContrast, 1536);
+    for (int i = 0; i < 768; i++) putLE(lowContrast, i % 97 == 0 ? 2555 : 2500);
+    uint32_t sum = 0;
+    for (uint8_t v : lowContrast) sum += v;
+    putLE(lowContrast, (uint16_t)sum);
+  }
+  Bytes binLE, binBE;
+  for (int i = 0; i < 1024; i++) {
+    uint16_t v = pixelValue(i % 768, 23, 3100);
+    putLE(binLE, v);
+    binBE.push_back((uint8_t)(v >> 8));
+    binBE.push_back((uint8_t)(v & 0xFF));
+  }
+  binLE.resize(1536);
+  std::string csv, hex;
+  for (int i = 0; i < 768; i++) {
+    char tmp[16];
+    snprintf(tmp, sizeof(tmp), "%d.%02d%s", 24 + i % 9, i % 100, (i % 32 == 31) ? "\n" : ",");
+    csv += tmp;
+    snprintf(tmp, sizeof(tmp), "0x%04X ", 29815 + i % 700);  // 开氏度*100
+    hex += tmp;
+  }
+  // 超过解码器栈缓冲的 token：长串前导 0 / 长小数 + 抵消它的指数，baseline 按完整 token 解析
+  std::string longCsv;
+  for (int i = 0; i < 500; i++) {
+    std::string zeros(60 + i % 40, '0');
+    char tmp[32];
+    if (i % 2) {
+      snprintf(tmp, sizeof(tmp), "%d.%02d,", 24 + i % 9, i % 100);
+      longCsv += zeros + tmp;
+    } else {
+      snprintf(tmp, sizeof(tmp), "%d%02de%zu,", 24 + i % 9, i % 100, zeros.size() + 2);  // 0.000…24NN e(z+2) = 24.NN
+      longCsv += "0." + zeros + tmp;
+    }
+  }
+  // 长度避开 256 的整数倍，否则会先走二进制猜测
+  csv += "\n";
+  hex += "\n";
+  longCsv += "\n";
+  Bytes badLenThenFrame = cat({{0x5A, 0x5A, 0x06, 0x02}, noise(40), f1538});  // 0x0206 不是受支持的长度
+
+  bool ok = true;
+  ok &= writeSeed(dir, "syn_protocol_1538.bin", f1538);
+  ok &= writeSeed(dir, "syn_protocol_1536.bin", protocolFrame(1536, 22, 3600));
+  ok &= writeSeed(dir, "syn_protocol_1540.bin", protocolFrame(1540, 26, 4000));
+  ok &= writeSeed(dir, "syn_protocol_bad_checksum.bin", protocolFrame(1538, 24, 3400, true));
+  // 热点 399.50：/100 缩放刚好不触发 /16 备用方案，K->C 平移后才合理
+  ok &= writeSeed(dir, "syn_protocol_kelvin_shift.bin", protocolFrame(1538, 370, 39950));
+  ok &= writeSeed(dir, "syn_protocol_low_contrast.bin", lowContrast);
+  ok &= writeSeed(dir, "syn_protocol_flat.bin", flat);
+  ok &= writeSeed(dir, "syn_protocol_truncated.bin", Bytes(f1538.begin(), f1538.begin() + 1500));
+  ok &= writeSeed(dir, "syn_stream_noise_two_frames.bin", cat({noise(37), f1538, protocolFrame(1538, 25, 3300), Bytes(f1538.begin(), f1538.begin() + 600)}));
+  ok &= writeSeed(dir, "syn_stream_bad_len_header.bin", badLenThenFrame);
+  ok &= writeSeed(dir, "syn_binary_le_1536.bin", binLE);
+  ok &= writeSeed(dir, "syn_binary_be_2048.bin", binBE);
+  ok &= writeSeed(dir, "syn_text_csv.txt", text(csv));
+  ok &= writeSeed(dir, "syn_text_hex.txt", text(hex));
+  ok &= writeSeed(dir, "syn_text_long_tokens.txt", text(longCsv));
+  ok &= writeSeed(dir, "syn_noise_4096.bin", noise(4096));
+  ok &= writeSeed(dir, "syn_short.bin", noise(16));
+  return ok ? 0 : 1;
+}
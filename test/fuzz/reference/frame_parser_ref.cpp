@@ -0,0 +1,146 @@
+#include "frame_parser_ref.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+namespace frame_parser_ref {
+
+bool parseProtocolFrame(const uint8_t *raw, size_t rawLen, float *frame, float *envTemp) {
+  const uint16_t EXPECT_PIXEL_COUNT = 768;
+  const uint16_t ALT_DECLARED[3] = {1538, 1536, 1540};
+  const uint16_t MIN_FRAME_TOTAL = 2 + 2 + 1536 + 2;
+  if (rawLen < MIN_FRAME_TOTAL) return false;
+
+  for (size_t start = 0; start + MIN_FRAME_TOTAL <= rawLen; ++start) {
+    if (raw[start] != 0x5A || raw[start+1] != 0x5A) continue;
+    uint16_t declaredLen = (uint16_t)raw[start+3] * 256 + raw[start+2];
+    bool lenSupported = false;
+    for (auto v : ALT_DECLARED) { if (declaredLen == v) { lenSupported = true; break; } }
+    if (!lenSupported) continue;
+    size_t pixelDataOffset = start + 4;
+    size_t pixelBytes = EXPECT_PIXEL_COUNT * 2;
+    size_t moduleTempOffset = pixelDataOffset + pixelBytes;
+    size_t checksumOffset;
+    if (declaredLen == 1536) {
+      checksumOffset = pixelDataOffset + pixelBytes;
+    } else if (declaredLen == 1538) {
+      checksumOffset = moduleTempOffset + 2;
+    } else {
+      checksumOffset = pixelDataOffset + declaredLen;
+    }
+    if (checksumOffset + 2 > rawLen) continue;
+    for (uint16_t px = 0; px < EXPECT_PIXEL_COUNT; ++px) {
+      uint8_t lo = raw[pixelDataOffset + px*2];
+      uint8_t hi = raw[pixelDataOffset + px*2 + 1];
+      uint16_t v = (uint16_t)hi << 8 | lo;
+      float tempC = v / 100.0f;
+      if (tempC < -60 || tempC > 400) tempC = v / 16.0f;
+      frame[px] = tempC;
+    }
+    float moduleTemp = NAN;
+    if (declaredLen != 1536) {
+      uint16_t moduleRaw = (uint16_t)raw[moduleTempOffset+1] << 8 | raw[moduleTempOffset];
+      moduleTemp = moduleRaw / 100.0f;
+    }
+    *envTemp = moduleTemp;
+    uint16_t chk = (uint16_t)raw[checksumOffset+1] << 8 | raw[checksumOffset];
+    uint32_t sum = 0;
+    size_t sumEnd = (declaredLen == 1536) ? (pixelDataOffset + pixelBytes) : (declaredLen == 1538 ? (moduleTempOffset + 2) : (pixelDataOffset + declaredLen));
+    for (size_t i = start; i < sumEnd; ++i) sum += raw[i];
+    bool checksumOK = (chk == (uint16_t)(sum & 0xFFFF));
+    float mn = frame[0], mx = frame[0];
+    for (uint16_t i=1;i<EXPECT_PIXEL_COUNT;++i){ if(frame[i]<mn) mn=frame[i]; if(frame[i]>mx) mx=frame[i]; }
+    bool valueOK = (mn > -55 && mx < 360 && (mx - mn) > 0.5);
+    if (!valueOK) {
+      for (uint16_t i=0;i<EXPECT_PIXEL_COUNT;++i) frame[i] = frame[i] - 273.15f;
+      mn = frame[0]; mx = frame[0];
+      for (uint16_t i=1;i<EXPECT_PIXEL_COUNT;++i){ if(frame[i]<mn) mn=frame[i]; if(frame[i]>mx) mx=frame[i]; }
+      valueOK = (mn > -55 && mx < 360 && (mx - mn) > 0.5);
+    }
+    if (valueOK) {
+      if (USE_STRICT_PROTOCOL && !checksumOK) return false;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool decodeBinaryFrame(const uint8_t *raw, size_t rawLen, bool littleEndian, float *frame) {
+  size_t pixels = rawLen / 2;
+  if (pixels < 768) return false;
+  for (size_t i = 0; i < 768; i++) {
+    uint8_t b1 = raw[2*i];
+    uint8_t b2 = raw[2*i + 1];
+    uint16_t v = littleEndian ? (b2 << 8 | b1) : (b1 << 8 | b2);
+    float tempC = (float)v / 100.0f;
+    if (tempC < -60 || tempC > 400) tempC = (float)v / 16.0f;
+    frame[i] = tempC;
+  }
+  float mn = frame[0], mx = frame[0];
+  for (int i = 1; i < 768; ++i) { if (frame[i] < mn) mn = frame[i]; if (frame[i] > mx) mx = frame[i]; }
+  return mn > -55 && mx < 360 && (mx - mn) > 1;
+}
+
+// String.trim() 语义
+static std::string trimmed(const uint8_t *data, size_t from, size_t to) {
+  while (from < to && isspace(data[from])) from++;
+  while (to > from && isspace(data[to-1])) to--;
+  return std::string((const char *)data + from, to - from);
+}
+
+bool parseGYMCUData(const uint8_t *data, size_t len, float *frame) {
+  int validCount = 0;
+  bool hasHex = false;
+  for (size_t i = 0; i + 1 < len; i++) {
+    if (data[i] == '0' && data[i+1] == 'x') { hasHex = true; break; }
+  }
+  if (hasHex || len > 1000) {
+    for (size_t i = 0; i + 3 < len && validCount < 768; i++) {
+      if (data[i] == '0' && data[i+1] == 'x') {
+        if (i + 6 <= len) {
+          std::string hexStr((const char *)data + i + 2, 4);
+          int hexVal = strtol(hexStr.c_str(), NULL, 16);
+          frame[validCount] = (float)hexVal / 100.0 - 273.15;
+          validCount++;
+          i += 5;
+        }
+      }
+    }
+  }
+  if (validCount < 100) {
+    validCount = 0;
+    size_t startPos = 0;
+    for (size_t i = 0; i < len && validCount < 768; i++) {
+      if (data[i] == ',' || data[i] == ' ' || data[i] == '\n' || i == len - 1) {
+        std::string tempStr = trimmed(data, startPos, i);
+        if (tempStr.length() > 0 && isdigit((uint8_t)tempStr[0])) {
+          float temp = (float)atof(tempStr.c_str());
+          if (temp > -50 && temp < 150) {
+            frame[validCount] = temp;
+            validCount++;
+          }
+        }
+        startPos = i + 1;
+      }
+    }
+  }
+  return validCount >= 400;
+}
+
+FrameSource decodeCapture(const uint8_t *raw, size_t rawLen, const float *prev, float *frame, float *envTemp) {
+  *envTemp = NAN;
+  if (rawLen >= 1536 && rawLen % 256 == 0) {
+    if (decodeBinaryFrame(raw, rawLen, true, frame)) return FRAME_SRC_BINARY_LE;
+    if (decodeBinaryFrame(raw, rawLen, false, frame)) return FRAME_SRC_BINARY_BE;
+  }
+  if (parseProtocolFrame(raw, rawLen, frame, envTemp)) return FRAME_SRC_PROTOCOL;
+  memcpy(frame, prev, 768 * sizeof(float));
+  if (parseGYMCUData(raw, rawLen, frame)) return FRAME_SRC_TEXT;
+  return FRAME_SRC_NONE;
+}
+
+}  // namespace frame_parser_ref
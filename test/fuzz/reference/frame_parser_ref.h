@@ -0,0 +1,27 @@
+// 差分测试参考解码器：冻结自重构前 (baseline) main.cpp 的 float 解析逻辑
+// 仅做机械改写：String -> (const uint8_t*, len)，去掉 Serial 打印，全局 frame[] / g_envTemp 改为出参。
+// 与 baseline 的有意差异（均为解析器隔离时确定的行为）：
+//   1. 文本解析前 frame 先恢复为 prev（baseline 中失败的二进制 / 协议尝试会残留在未覆盖像素里）
+//   2. 十六进制循环以 i + 3 < len 为界（baseline 在 len < 3 时无符号下溢，结果相同但会空转）
+
+#ifndef FRAME_PARSER_REF_H
+#define FRAME_PARSER_REF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frame_parser.h"
+
+namespace frame_parser_ref {
+
+bool parseProtocolFrame(const uint8_t *raw, size_t rawLen, float *frame, float *envTemp);
+bool decodeBinaryFrame(const uint8_t *raw, size_t rawLen, bool littleEndian, float *frame);
+bool parseGYMCUData(const uint8_t *data, size_t len, float *frame);
+
+// baseline readMLXFrame 窗口结束后的解码顺序：二进制猜测 -> 协议帧 -> 文本
+// 返回接受的解码器，全部拒绝时返回 FRAME_SRC_NONE
+FrameSource decodeCapture(const uint8_t *raw, size_t rawLen, const float *prev, float *frame, float *envTemp);
+
+}  // namespace frame_parser_ref
+
+#endif
@@ -0,0 +1,10 @@
+# env:native 专用：ASan / UBSan 需要同时出现在编译与链接参数里，build_flags 只作用于编译
+Import("env")
+
+SANITIZE_FLAGS = [
+    "-fsanitize=address,undefined",
+    "-fno-sanitize-recover=all",
+    "-fno-omit-frame-pointer",
+]
+
+env.Append(CCFLAGS=SANITIZE_FLAGS, LINKFLAGS=SANITIZE_FLAGS)
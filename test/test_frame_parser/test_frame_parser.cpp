@@ -0,0 +1,199 @@
+// 解码器单元测试 (主机端)：pio test -e native
+// 覆盖协议帧三种长度、拒绝路径，以及“被拒绝的捕获不修改已发布帧”
+
+#include <math.h>
+#include <string.h>
+#include <unity.h>
+
+#include <vector>
+
+#include "frame_parser.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+static void putLE(Bytes &b, uint16_t v) {
+  b.push_back((uint8_t)(v & 0xFF));
+  b.push_back((uint8_t)(v >> 8));
+}
+
+// 像素 25.00°C + 每像素 0.01°C 梯度，模块温度 28.50°C
+static Bytes makeProtocolFrame(uint16_t declaredLen, bool flat = false) {
+  Bytes b = {0x5A, 0x5A};
+  putLE(b, declaredLen);
+  for (int i = 0; i < MLX_FRAME_PIXELS; i++) putLE(b, (uint16_t)(2500 + (flat ? 0 : i)));
+  if (declaredLen >= 1538) putLE(b, 2850);
+  if (declaredLen == 1540) putLE(b, 0);
+  uint32_t sum = 0;
+  for (uint8_t v : b) sum += v;
+  putLE(b, (uint16_t)sum);
+  return b;
+}
+
+static int16_t g_out[MLX_FRAME_PIXELS];
+static FrameDecodeInfo g_info;
+
+void setUp(void) {
+  memset(g_out, 0, sizeof(g_out));
+  frameDecodeInfoReset(&g_info);
+}
+
+void tearDown(void) {}
+
+void test_protocol_1538_accepted(void) {
+  Bytes f = makeProtocolFrame(1538);
+  TEST_ASSERT_TRUE(parseProtocolFrame(f.data(), f.size(), g_out, &g_info));
+  TEST_ASSERT_EQUAL(FRAME_SRC_PROTOCOL, g_info.source);
+  TEST_ASSERT_EQUAL(0, g_info.start);
+  TEST_ASSERT_EQUAL(1544, g_info.frameLen);
+  TEST_ASSERT_TRUE(g_info.checksumOK);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 28.5f, g_info.envTemp);
+  TEST_ASSERT_EQUAL_INT16(2500, g_out[0]);
+  TEST_ASSERT_EQUAL_INT16(2500 + 767, g_out[767]);
+}
+
+void test_protocol_1536_has_no_env(void) {
+  Bytes f = makeProtocolFrame(1536);
+  TEST_ASSERT_TRUE(parseProtocolFrame(f.data(), f.size(), g_out, &g_info));
+  TEST_ASSERT_EQUAL(1542, g_info.frameLen);
+  TEST_ASSERT_TRUE(isnan(g_info.envTemp));
+}
+
+void test_protocol_1540_frame_len(void) {
+  Bytes f = makeProtocolFrame(1540);
+  TEST_ASSERT_TRUE(parseProtocolFrame(f.data(), f.size(), g_out, &g_info));
+  TEST_ASSERT_EQUAL(1546, g_info.frameLen);
+  TEST_ASSERT_TRUE(g_info.checksumOK);
+}
+
+void test_protocol_after_noise_reports_offset(void) {
+  Bytes f = {0x00, 0x5A, 0x13, 0x5A, 0x5A, 0x06, 0x02}; // 含一个不受支持长度的伪帧头
+  Bytes frame = makeProtocolFrame(1538);
+  f.insert(f.end(), frame.begin(), frame.end());
+  TEST_ASSERT_TRUE(parseProtocolFrame(f.data(), f.size(), g_out, &g_info));
+  TEST_ASSERT_EQUAL(7, g_info.start);
+  TEST_ASSERT_EQUAL(f.size(), g_info.start + g_info.frameLen);
+}
+
+void test_protocol_bad_checksum_flagged(void) {
+  Bytes f = makeProtocolFrame(1538);
+  f.back() ^= 0x01;
+  bool ok = parseProtocolFrame(f.data(), f.size(), g_out, &g_info);
+  TEST_ASSERT_FALSE(g_info.checksumOK);
+  TEST_ASSERT_EQUAL(!USE_STRICT_PROTOCOL, ok);
+}
+
+// 严格模式拒绝校验失败的帧时仍报告其位置与长度，滚动采集据此丢弃该帧、继续解析后面的帧
+void test_protocol_bad_checksum_then_good_frame(void) {
+  Bytes f = makeProtocolFrame(1538);
+  f.back() ^= 0x01;
+  Bytes good = makeProtocolFrame(1540);
+  f.insert(f.end(), good.begin(), good.end());
+  bool ok = parseProtocolFrame(f.data(), f.size(), g_out, &g_info);
+  TEST_ASSERT_EQUAL(0, g_info.start);
+  TEST_ASSERT_EQUAL(1544, g_info.frameLen);
+  if (!USE_STRICT_PROTOCOL) {
+    TEST_ASSERT_TRUE(ok);
+    return;
+  }
+  TEST_ASSERT_FALSE(ok);
+  TEST_ASSERT_TRUE(g_info.strictRejected);
+  size_t used = g_info.start + g_info.frameLen;
+  frameDecodeInfoReset(&g_info);
+  TEST_ASSERT_TRUE(parseProtocolFrame(f.data() + used, f.size() - used, g_out, &g_info));
+  TEST_ASSERT_EQUAL(1546, g_info.frameLen);
+  TEST_ASSERT_TRUE(g_info.checksumOK);
+}
+
+void test_protocol_flat_rejected(void) {
+  Bytes f = makeProtocolFrame(1538, true);
+  TEST_ASSERT_FALSE(parseProtocolFrame(f.data(), f.size(), g_out, &g_info));
+  TEST_ASSERT_EQUAL(FRAME_SRC_NONE, g_info.source);
+}
+
+void test_protocol_truncated_rejected(void) {
+  Bytes f = makeProtocolFrame(1538);
+  TEST_ASSERT_FALSE(parseProtocolFrame(f.data(), f.size() - 1, g_out, &g_info));
+  TEST_ASSERT_EQUAL(0, g_info.candidates);
+}
+
+void test_binary_little_endian(void) {
+  Bytes f;
+  for (int i = 0; i < MLX_FRAME_PIXELS; i++) putLE(f, (uint16_t)(2300 + i % 200));
+  TEST_ASSERT_TRUE(decodeBinaryFrame(f.data(), f.size(), true, g_out, &g_info));
+  TEST_ASSERT_EQUAL(FRAME_SRC_BINARY_LE, g_info.source);
+  TEST_ASSERT_EQUAL_INT16(2300 + 199, g_out[199]);
+  TEST_ASSERT_FALSE(decodeBinaryFrame(f.data(), f.size() - 1, true, g_out, &g_info));
+}
+
+void test_text_csv(void) {
+  Bytes f;
+  for (int i = 0; i < 500; i++) {
+    const char *tok = (i % 2) ? "26.25," : "24.5,";
+    f.insert(f.end(), tok, tok + strlen(tok));
+  }
+  TEST_ASSERT_TRUE(parseGYMCUData(f.data(), f.size(), g_out, &g_info));
+  TEST_ASSERT_EQUAL(500, g_info.validCount);
+  TEST_ASSERT_EQUAL_INT16(2450, g_out[0]);
+  TEST_ASSERT_EQUAL_INT16(2625, g_out[1]);
+}
+
+// 超过栈缓冲的 token 与 baseline String.toFloat() 一致：按完整 token 解析，不截断
+void test_text_overlong_tokens(void) {
+  const char *text = "000000000000000000000000000000000000000000000000000000000000000025.5,"
+                     "0.000000000000000000000000000000000000000000000000000000000000000000265e68,"
+                     "27.000000000000000000000000000000000000000000000000000000000000000000001,"
+                     "0x00000000000000000000000000000000000000000000000000000000000000000001Cp0,";
+  Bytes f(text, text + strlen(text));
+  parseGYMCUData(f.data(), f.size(), g_out, &g_info);
+  TEST_ASSERT_EQUAL(4, g_info.validCount);
+  TEST_ASSERT_EQUAL_INT16(2550, g_out[0]);
+  TEST_ASSERT_EQUAL_INT16(2650, g_out[1]);
+  TEST_ASSERT_EQUAL_INT16(2700, g_out[2]);
+  TEST_ASSERT_EQUAL_INT16(2800, g_out[3]);
+}
+
+// 被拒绝的捕获：已发布帧逐字节不变，解码工作槽的内容不会被发布
+static void assertRejectedKeepsPublished(const Bytes &raw) {
+  int16_t published[MLX_FRAME_PIXELS];
+  int16_t snapshot[MLX_FRAME_PIXELS];
+  for (int i = 0; i < MLX_FRAME_PIXELS; i++) published[i] = (int16_t)(3000 - i);
+  memcpy(snapshot, published, sizeof(published));
+  TEST_ASSERT_FALSE(decodeCapture(raw.data(), raw.size(), published, g_out, &g_info));
+  TEST_ASSERT_EQUAL(FRAME_SRC_NONE, g_info.source);
+  TEST_ASSERT_EQUAL_MEMORY(snapshot, published, sizeof(published));
+}
+
+void test_rejected_capture_keeps_published_frame(void) {
+  assertRejectedKeepsPublished(makeProtocolFrame(1538, true)); // 协议帧数值不合理
+  Bytes truncated = makeProtocolFrame(1538);
+  truncated.resize(1500);
+  assertRejectedKeepsPublished(truncated);
+  Bytes noise;
+  for (int i = 0; i < 1000; i++) noise.push_back((uint8_t)(i * 37 + 11));
+  assertRejectedKeepsPublished(noise);
+}
+
+void test_to_centi_saturates(void) {
+  TEST_ASSERT_EQUAL_INT16(32767, toCenti(400.0f));
+  TEST_ASSERT_EQUAL_INT16(-32768, toCenti(-400.0f));
+  TEST_ASSERT_EQUAL_INT16(0, toCenti(NAN));
+  TEST_ASSERT_EQUAL_INT16(2551, toCenti(25.506f));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_protocol_1538_accepted);
+  RUN_TEST(test_protocol_1536_has_no_env);
+  RUN_TEST(test_protocol_1540_frame_len);
+  RUN_TEST(test_protocol_after_noise_reports_offset);
+  RUN_TEST(test_protocol_bad_checksum_flagged);
+  RUN_TEST(test_protocol_bad_checksum_then_good_frame);
+  RUN_TEST(test_protocol_flat_rejected);
+  RUN_TEST(test_protocol_truncated_rejected);
+  RUN_TEST(test_binary_little_endian);
+  RUN_TEST(test_text_csv);
+  RUN_TEST(test_text_overlong_tokens);
+  RUN_TEST(test_rejected_capture_keeps_published_frame);
+  RUN_TEST(test_to_centi_saturates);
+  return UNITY_END();
+}
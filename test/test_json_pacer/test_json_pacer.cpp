@@ -0,0 +1,75 @@
+// JSON 节拍器单元测试 (主机端)：pio test -e native
+// 以不同到达间隔模拟 10 秒传感器帧流，检查输出速率贴近 8Hz 且不超过上限
+
+#include <unity.h>
+
+#include "json_pacer.h"
+
+static const uint32_t INTERVAL = 125;
+static const uint32_t JITTER = 30;
+static const uint32_t DURATION = 10000;
+
+// 帧每 periodMs 到达，jitter 序列叠加在到达时刻上；返回发送帧数
+static unsigned simulate(uint32_t periodMs, const int *jitter, unsigned jitterLen, uint32_t start = 0) {
+  JsonPacer p = {INTERVAL, JITTER, 0, false};
+  unsigned sent = 0;
+  for (unsigned k = 0; (uint32_t)(k * periodMs) < DURATION; k++) {
+    uint32_t now = start + k * periodMs + (jitterLen ? jitter[k % jitterLen] : 0);
+    if (p.due(now)) {
+      p.sent(now);
+      sent++;
+    }
+  }
+  return sent;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_nominal_8hz_all_sent(void) {
+  TEST_ASSERT_EQUAL(80, simulate(125, nullptr, 0));
+}
+
+void test_fast_sensor_124ms_keeps_8hz(void) {
+  // 81 帧到达；上限 8Hz，最多丢 1–2 帧，不会隔帧丢弃
+  unsigned sent = simulate(124, nullptr, 0);
+  TEST_ASSERT_GREATER_OR_EQUAL(79, sent);
+  TEST_ASSERT_LESS_OR_EQUAL(81, sent);
+}
+
+void test_early_by_batching_not_skipped(void) {
+  // UART 批量读取让部分帧提前 / 推迟几毫秒检测到
+  const int jitter[] = {0, -3, 2, -1, 4, -5, 1, 0};
+  TEST_ASSERT_EQUAL(80, simulate(125, jitter, 8));
+}
+
+void test_fast_input_capped(void) {
+  // 20Hz 输入：输出不超过 8Hz (+1 首帧)
+  TEST_ASSERT_LESS_OR_EQUAL(81, simulate(50, nullptr, 0));
+  TEST_ASSERT_GREATER_OR_EQUAL(79, simulate(50, nullptr, 0));
+}
+
+void test_resync_after_gap_no_burst(void) {
+  JsonPacer p = {INTERVAL, JITTER, 0, false};
+  p.sent(0);
+  // 停顿 2 秒后恢复：只发一帧并重新对齐，不补发积压
+  TEST_ASSERT_TRUE(p.due(2000));
+  p.sent(2000);
+  TEST_ASSERT_FALSE(p.due(2010));
+  TEST_ASSERT_TRUE(p.due(2125));
+}
+
+void test_millis_wraparound(void) {
+  TEST_ASSERT_EQUAL(80, simulate(125, nullptr, 0, 0xFFFFF000u));
+}
+
+int main(int argc, char **argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_nominal_8hz_all_sent);
+  RUN_TEST(test_fast_sensor_124ms_keeps_8hz);
+  RUN_TEST(test_early_by_batching_not_skipped);
+  RUN_TEST(test_fast_input_capped);
+  RUN_TEST(test_resync_after_gap_no_burst);
+  RUN_TEST(test_millis_wraparound);
+  return UNITY_END();
+}